@@ -47,6 +47,8 @@ if (BUILD_LIBPOLY)
   colored_option("   xcb-xkb" WITH_XKB Xcb_XKB_VERSION)
   colored_option("   xcb-xrm" WITH_XRM Xcb_XRM_VERSION)
   colored_option("   xcb-cursor" WITH_XCURSOR Xcb_CURSOR_VERSION)
+  colored_option("   xcb-shm" WITH_XSHM Xcb_SHM_VERSION)
+  colored_option("   xcb-present" WITH_XPRESENT Xcb_PRESENT_VERSION)
 
   message(STATUS " Log options:")
   colored_option("   Trace logging" DEBUG_LOGGER)
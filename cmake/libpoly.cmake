@@ -19,6 +19,8 @@ checklib(WITH_XKB "pkg-config" xcb-xkb)
 checklib(WITH_XRM "pkg-config" xcb-xrm)
 checklib(WITH_XRANDR_MONITORS "pkg-config" "xcb-randr>=1.12")
 checklib(WITH_XCURSOR "pkg-config" "xcb-cursor")
+checklib(WITH_XSHM "pkg-config" "xcb-shm")
+checklib(WITH_XPRESENT "pkg-config" "xcb-present")
 
 option(ENABLE_ALSA "Enable alsa support" ON)
 option(ENABLE_CURL "Enable curl support" ON)
@@ -33,6 +35,8 @@ option(WITH_XRANDR_MONITORS "xcb-randr monitor support" ON)
 option(WITH_XKB "xcb-xkb support" ON)
 option(WITH_XRM "xcb-xrm support" ON)
 option(WITH_XCURSOR "xcb-cursor support" ON)
+option(WITH_XSHM "xcb-shm support" ON)
+option(WITH_XPRESENT "xcb-present support" ON)
 
 option(DEBUG_LOGGER "Trace logging" ON)
 
@@ -88,6 +92,12 @@ endif()
 if (WITH_XRM)
   list(APPEND XORG_EXTENSIONS XRM)
 endif()
+if (WITH_XSHM)
+  list(APPEND XORG_EXTENSIONS SHM)
+endif()
+if (WITH_XPRESENT)
+  list(APPEND XORG_EXTENSIONS PRESENT)
+endif()
 
 # Set min xrandr version required
 if (WITH_XRANDR_MONITORS)
@@ -20,7 +20,9 @@ set(XCB_known_components
   COMPOSITE
   XKB
   XRM
-  CURSOR)
+  CURSOR
+  SHM
+  PRESENT)
 
 # Deducing header from the name of the component
 foreach(_comp ${XCB_known_components})
@@ -20,6 +20,8 @@ if [ "$POLYBAR_BUILD_TYPE" != "minimal" ]; then
   WITH_XKB=ON
   WITH_XRANDR_MONITORS=ON
   WITH_XCURSOR=ON
+  WITH_XSHM=ON
+  WITH_XPRESENT=ON
 fi
 
 if [ "$POLYBAR_BUILD_TYPE" = "tests" ]; then
@@ -42,4 +44,6 @@ cmake \
   -DWITH_XKB="${WITH_XKB:-OFF}" \
   -DWITH_XRANDR_MONITORS="${WITH_XRANDR_MONITORS:-OFF}" \
   -DWITH_XCURSOR="${WITH_XCURSOR:-OFF}" \
+  -DWITH_XSHM="${WITH_XSHM:-OFF}" \
+  -DWITH_XPRESENT="${WITH_XPRESENT:-OFF}" \
   ..
@@ -6,6 +6,7 @@
 #include "settings.hpp"
 
 // fwd
+struct pollfd;
 struct _snd_ctl;
 struct _snd_hctl_elem;
 struct _snd_hctl;
@@ -29,6 +30,13 @@ namespace alsa {
     bool test_device_plugged();
     void process_events();
 
+    int poll_descriptors_count();
+    int poll_descriptors(struct pollfd* fds, unsigned int space);
+    bool handle_revents(struct pollfd* fds, unsigned int nfds);
+
+   protected:
+    bool read_events();
+
    private:
     int m_numid{0};
 
@@ -6,6 +6,7 @@
 #include "settings.hpp"
 
 // fwd
+struct pollfd;
 struct _snd_mixer;
 struct _snd_mixer_elem;
 struct _snd_mixer_selem_id;
@@ -30,6 +31,10 @@ namespace alsa {
     bool wait(int timeout = -1);
     int process_events();
 
+    int poll_descriptors_count();
+    int poll_descriptors(struct pollfd* fds, unsigned int space);
+    bool handle_revents(struct pollfd* fds, unsigned int nfds);
+
     int get_volume();
     int get_normalized_volume();
     void set_volume(float percentage);
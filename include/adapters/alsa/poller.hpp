@@ -0,0 +1,62 @@
+#pragma once
+
+#include <poll.h>
+
+#include "common.hpp"
+#include "settings.hpp"
+
+POLYBAR_NS
+
+namespace alsa {
+  class mixer;
+  class control;
+
+  /**
+   * Waits for events on several mixers and controls at once.
+   *
+   * The poll descriptors of all handles are gathered into a single poll set,
+   * after poll returns only the handles whose descriptors fired are serviced.
+   */
+  class poller {
+   public:
+    explicit poller();
+    ~poller();
+
+    poller(const poller& o) = delete;
+    poller& operator=(const poller& o) = delete;
+
+    void add(shared_ptr<mixer> m);
+    void add(shared_ptr<control> c);
+
+    /**
+     * Block until one of the handles has events, the timeout expires or
+     * interrupt() is called.
+     *
+     * A negative timeout blocks indefinitely.
+     *
+     * @return true if a mixer reported events or the value of a control changed
+     */
+    bool wait(int timeout = -1);
+
+    /**
+     * Wake up a thread blocking in wait()
+     */
+    void interrupt();
+
+   private:
+    struct source {
+      shared_ptr<mixer> m;
+      shared_ptr<control> c;
+      size_t offset;
+      size_t count;
+    };
+
+    void build();
+
+    vector<source> m_sources;
+    vector<struct pollfd> m_fds;
+    int m_interrupt{-1};
+  };
+} // namespace alsa
+
+POLYBAR_NS_END
@@ -63,6 +63,7 @@ namespace mpd {
 
     operator bool();
 
+    int get_id();
     string get_artist();
     string get_album_artist();
     string get_album();
@@ -74,6 +75,31 @@ namespace mpd {
     mpd_song_t m_song;
   };
 
+  // }}}
+  // struct : songinfo {{{
+
+  /**
+   * Tags of a song, extracted once and kept for as long as the song stays current.
+   *
+   * A song is identified by its id together with the queue version, mpd bumps
+   * the queue version whenever the tags of a queued song change (e.g. the
+   * title of a radio stream).
+   */
+  struct songinfo {
+    int id{-1};
+    unsigned queue_version{0};
+
+    string artist;
+    string album_artist;
+    string album;
+    string title;
+    string date;
+
+    bool matches(int songid, unsigned version) const {
+      return id == songid && queue_version == version;
+    }
+  };
+
   // }}}
   // class : mpdconnection {{{
 
@@ -93,6 +119,29 @@ namespace mpd {
     void idle();
     int noidle();
 
+    /**
+     * Block until the server answers the pending idle command, the timeout
+     * expires or interrupt() is called.
+     *
+     * A negative timeout blocks indefinitely.
+     *
+     * @return true if the connection became readable
+     */
+    bool wait(chrono::milliseconds timeout);
+
+    /**
+     * Wake up a thread blocking in wait()
+     */
+    void interrupt();
+
+    /**
+     * Collect the result of the pending idle command without blocking.
+     *
+     * @return The changed subsystems (mpd_idle flags) or 0 if the server did
+     *         not report any changes yet
+     */
+    int recv_idle();
+
     unique_ptr<mpdstatus> get_status();
     unique_ptr<mpdstatus> get_status_safe();
     unique_ptr<mpdsong> get_song();
@@ -125,6 +174,7 @@ namespace mpd {
     bool m_listactive = false;
     bool m_idle = false;
     int m_fd = -1;
+    int m_interrupt = -1;
 
     string m_host;
     unsigned int m_port;
@@ -151,11 +201,13 @@ namespace mpd {
 
     int get_songid() const;
     int get_queuelen() const;
+    unsigned get_queue_version() const;
     unsigned get_total_time() const;
     unsigned get_elapsed_time() const;
-    unsigned get_elapsed_percentage();
-    string get_formatted_elapsed();
-    string get_formatted_total();
+    unsigned long get_elapsed_time_ms() const;
+    unsigned get_elapsed_percentage() const;
+    string get_formatted_elapsed() const;
+    string get_formatted_total() const;
     int get_seek_position(int percentage);
 
    private:
@@ -170,10 +222,18 @@ namespace mpd {
 
     int m_songid{0};
     int m_queuelen{0};
+    unsigned m_queue_version{0U};
 
     unsigned long m_total_time{0UL};
-    unsigned long m_elapsed_time{0UL};
+
+    /*
+     * Elapsed time as reported by the server at m_fetched_at.
+     *
+     * While playing, the current position is extrapolated from this so that
+     * the server doesn't have to be queried for every tick.
+     */
     unsigned long m_elapsed_time_ms{0UL};
+    chrono::steady_clock::time_point m_fetched_at{};
   };
 
   // }}}
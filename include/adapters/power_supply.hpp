@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+
+#include "common.hpp"
+#include "errors.hpp"
+#include "utils/file.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+namespace power_supply {
+  DEFINE_ERROR(power_supply_error);
+
+  /**
+   * A sysfs attribute that is opened once and re-read with pread.
+   *
+   * sysfs regenerates the contents of an attribute when it is read from
+   * offset 0, so the file never has to be reopened.
+   */
+  class attribute : public non_copyable_mixin {
+   public:
+    explicit attribute(string path);
+
+    const string& path() const;
+
+    /**
+     * Read the current contents without trailing newline.
+     */
+    string read() const;
+    unsigned long read_ulong() const;
+    long read_long() const;
+
+   private:
+    string m_path;
+    file_descriptor m_fd;
+  };
+
+  /**
+   * Receives kernel uevents for the power_supply subsystem.
+   *
+   * Listens on a NETLINK_KOBJECT_UEVENT socket, the kernel sends a uevent
+   * whenever an adapter is plugged in or removed or a battery changes its
+   * status (and, depending on the driver, its capacity).
+   */
+  class uevent_monitor : public non_copyable_mixin, public non_movable_mixin {
+   public:
+    explicit uevent_monitor();
+    ~uevent_monitor();
+
+    /**
+     * Block until a power_supply uevent arrives, the timeout expires or
+     * interrupt() is called.
+     *
+     * A negative timeout blocks indefinitely.
+     *
+     * @return true if at least one power_supply uevent was received. All pending
+     *         uevents are consumed.
+     */
+    bool wait(std::chrono::milliseconds timeout);
+
+    /**
+     * Wake up a thread blocking in wait()
+     */
+    void interrupt();
+
+   private:
+    bool read_events();
+
+    int m_socket{-1};
+    int m_interrupt{-1};
+  };
+} // namespace power_supply
+
+POLYBAR_NS_END
@@ -3,7 +3,7 @@
 #include <pulse/pulseaudio.h>
 
 #include <atomic>
-#include <queue>
+#include <chrono>
 
 #include "common.hpp"
 #include "errors.hpp"
@@ -24,7 +24,6 @@ DEFINE_ERROR(pulseaudio_error);
 class pulseaudio {
   // events to add to our queue
   enum class evtype { NEW = 0, CHANGE, REMOVE, SERVER };
-  using queue = std::queue<evtype>;
 
  public:
   explicit pulseaudio(const logger& logger, string&& sink_name, bool m_max_volume);
@@ -35,7 +34,22 @@ class pulseaudio {
 
   const string& get_name();
 
-  bool wait();
+  /**
+   * Block until there are events to process, the timeout expires or
+   * interrupt() is called.
+   *
+   * A negative timeout blocks indefinitely.
+   *
+   * @return true if there are events to process
+   */
+  bool wait(std::chrono::milliseconds timeout = std::chrono::milliseconds{-1});
+
+  /**
+   * Wake up a thread blocking in wait()
+   */
+  void interrupt();
+
+  bool has_events() const;
   int process_events();
 
   int get_volume();
@@ -55,6 +69,15 @@ class pulseaudio {
   static void sink_info_callback(pa_context* context, const pa_sink_info* info, int eol, void* userdata);
   static void context_state_callback(pa_context* context, void* userdata);
 
+  static void operation_callback(pa_context* context, int success, void* userdata);
+  static void volume_timer_callback(
+      pa_mainloop_api* api, pa_time_event* event, const struct timeval* tv, void* userdata);
+
+  void push_event(evtype type);
+  void schedule_volume();
+  void send_volume();
+  bool has_pending_changes() const;
+
   inline void wait_loop(pa_operation* op, pa_threaded_mainloop* loop);
 
   const logger& m_log;
@@ -71,10 +94,47 @@ class pulseaudio {
   // default sink name
   static constexpr auto DEFAULT_SINK = "@DEFAULT_SINK@";
 
+  /**
+   * Volume changes within this window are sent to the server as a single request
+   */
+  static constexpr pa_usec_t VOLUME_DELAY{20 * PA_USEC_PER_MSEC};
+
+  /**
+   * Timer for sending the accumulated volume changes
+   */
+  pa_time_event* m_volume_event{nullptr};
+  bool m_volume_scheduled{false};
+
+  /**
+   * cv was changed locally and has not been sent yet
+   */
+  bool m_volume_dirty{false};
+
+  /**
+   * Number of volume and mute requests that have not been acknowledged yet.
+   *
+   * While there are any, sink info replies don't overwrite the local state,
+   * which already reflects the requested values.
+   */
+  int m_pending_ops{0};
+
   pa_context* m_context{nullptr};
   pa_threaded_mainloop* m_mainloop{nullptr};
 
-  queue m_events;
+  /**
+   * Pending events, one bit per evtype.
+   *
+   * Events are pushed from the PulseAudio thread (and from the thread handling
+   * actions) and consumed by the module thread. Multiple events of the same
+   * type are collapsed into a single bit, since processing one of them
+   * already fetches the current state.
+   */
+  std::atomic<unsigned int> m_events{0U};
+
+  /**
+   * eventfd that is signalled whenever an event is pushed
+   */
+  int m_eventfd{-1};
 
   // specified sink name
   string spec_s_name;
@@ -153,18 +153,39 @@ namespace cairo {
       return *this;
     }
 
-    context& operator<<(const textblock& t) {
-      double x, y;
+    /**
+     * Draws the run at the current point and moves the current point behind it
+     */
+    context& operator<<(const text_run& run) {
+      double x{0.0}, y{0.0};
       position(&x, &y);
 
+      auto fontextents = run.face->extents();
+      run.face->render(m_c, run.text, x, y - (fontextents.descent / 2 - fontextents.height / 4) + run.face->offset());
+
+      // Rendering moves the current point to the end of the glyphs, but not vertically
+      position(&x);
+      *this << abspos{x, y};
+      return *this;
+    }
+
+    /**
+     * Splits the text into runs that are each drawn with a single font
+     *
+     * Characters are looked up in the preferred font first, the other fonts are only used as a fallback for single
+     * characters. Nothing is drawn, the runs only carry the advance, so the text can be measured before it is placed.
+     */
+    vector<text_run> shape(const string& contents, int preferred_font) {
+      vector<text_run> runs;
+
       // Prioritize the preferred font
       vector<shared_ptr<font>> fns(m_fonts.begin(), m_fonts.end());
 
-      if (t.font > 0 && t.font <= std::distance(fns.begin(), fns.end())) {
-        std::iter_swap(fns.begin(), fns.begin() + t.font - 1);
+      if (preferred_font > 0 && preferred_font <= std::distance(fns.begin(), fns.end())) {
+        std::iter_swap(fns.begin(), fns.begin() + preferred_font - 1);
       }
 
-      string utf8 = t.contents;
+      string utf8 = contents;
       string_util::unicode_charlist chars;
       bool valid = string_util::utf8_to_ucs4(utf8, chars);
 
@@ -202,10 +223,7 @@ namespace cairo {
             end++;
           }
 
-          // Use the font
-          f->use();
-
-          // Get subset extents
+          // Get subset extents, cairo caches the extents of each glyph
           cairo_text_extents_t extents;
           f->textwidth(subset, &extents);
 
@@ -213,29 +231,7 @@ namespace cairo {
            * Make sure we don't advance partial pixels, this can cause problems
            * later when cairo renders background colors over half-pixels.
            */
-          extents.x_advance = std::ceil(extents.x_advance);
-
-          // Draw the background
-          if (t.bg_rect.h != 0.0) {
-            save();
-            cairo_set_operator(m_c, t.bg_operator);
-            *this << t.bg;
-            cairo_rectangle(m_c, t.bg_rect.x + *t.x_advance, t.bg_rect.y + *t.y_advance,
-                t.bg_rect.w + extents.x_advance, t.bg_rect.h);
-            cairo_fill(m_c);
-            restore();
-          }
-
-          // Render subset
-          auto fontextents = f->extents();
-          f->render(subset, x, y - (fontextents.descent / 2 - fontextents.height / 4) + f->offset());
-
-          // Get updated position
-          position(&x, nullptr);
-
-          // Increase position
-          *t.x_advance += extents.x_advance;
-          *t.y_advance += extents.y_advance;
+          runs.push_back(text_run{f, move(subset), std::ceil(extents.x_advance), extents.y_advance});
 
           chars.erase(chars.begin(), end);
           break;
@@ -249,7 +245,7 @@ namespace cairo {
 
         std::array<char, 5> unicode{};
         string_util::ucs4_to_utf8(unicode, chars.begin()->codepoint);
-        m_log.warn("Dropping unmatched character '%s' (U+%04x) in '%s'", unicode.data(), chars.begin()->codepoint, t.contents);
+        m_log.warn("Dropping unmatched character '%s' (U+%04x) in '%s'", unicode.data(), chars.begin()->codepoint, contents);
         utf8.erase(chars.begin()->offset, chars.begin()->length);
         for (auto&& c : chars) {
           c.offset -= chars.begin()->length;
@@ -257,7 +253,7 @@ namespace cairo {
         chars.erase(chars.begin(), ++chars.begin());
       }
 
-      return *this;
+      return runs;
     }
 
     context& operator<<(shared_ptr<font>&& f) {
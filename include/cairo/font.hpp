@@ -2,6 +2,9 @@
 
 #include <cairo/cairo-ft.h>
 
+#include <map>
+#include <mutex>
+
 #include "cairo/types.hpp"
 #include "cairo/utils.hpp"
 #include "common.hpp"
@@ -41,13 +44,17 @@ class font {
 
   virtual size_t match(string_util::unicode_character& character) = 0;
   virtual size_t match(string_util::unicode_charlist& charlist) = 0;
-  virtual size_t render(const string& text, double x = 0.0, double y = 0.0) = 0;
+  /**
+   * Draws the text onto the given context
+   *
+   * Scaled fonts can be used from several threads at once, as long as every thread draws onto its own context.
+   */
+  virtual size_t render(cairo_t* cr, const string& text, double x = 0.0, double y = 0.0) = 0;
   virtual void textwidth(const string& text, cairo_text_extents_t* extents) = 0;
 
  protected:
   cairo_t* m_cairo;
   cairo_font_face_t* m_font_face{nullptr};
-  cairo_font_extents_t m_extents{};
   double m_offset{0.0};
 };
 
@@ -98,8 +105,9 @@ class font_fc : public font {
   }
 
   cairo_font_extents_t extents() override {
-    cairo_scaled_font_extents(m_scaled, &m_extents);
-    return m_extents;
+    cairo_font_extents_t extents{};
+    cairo_scaled_font_extents(m_scaled, &extents);
+    return extents;
   }
 
   string name() const override {
@@ -208,7 +216,7 @@ class font_fc : public font {
     return available_chars;
   }
 
-  size_t render(const string& text, double x = 0.0, double y = 0.0) override {
+  size_t render(cairo_t* cr, const string& text, double x = 0.0, double y = 0.0) override {
     cairo_glyph_t* glyphs{nullptr};
     cairo_text_cluster_t* clusters{nullptr};
     cairo_text_cluster_flags_t cf{};
@@ -253,9 +261,10 @@ class font_fc : public font {
 
       cairo_text_extents_t extents{};
       cairo_scaled_font_glyph_extents(m_scaled, glyphs, nglyphs, &extents);
-      cairo_show_text_glyphs(m_cairo, utf8.c_str(), utf8.size(), glyphs, nglyphs, clusters, nclusters, cf);
-      cairo_fill(m_cairo);
-      cairo_move_to(m_cairo, x + extents.x_advance, 0.0);
+      cairo_set_scaled_font(cr, m_scaled);
+      cairo_show_text_glyphs(cr, utf8.c_str(), utf8.size(), glyphs, nglyphs, clusters, nclusters, cf);
+      cairo_fill(cr);
+      cairo_move_to(cr, x + extents.x_advance, 0.0);
     }
 
     cairo_glyph_free(glyphs);
@@ -298,20 +307,30 @@ class font_fc : public font {
 };
 
 /**
- * Match and create font from given fontconfig pattern
+ * Match a fontconfig pattern against the installed fonts
+ *
+ * Matches are cached, so that bars in the same process using the same font only match it once. The caller owns a
+ * reference to the returned pattern.
+ *
+ * Can be called from multiple threads at once.
  */
-inline decltype(auto) make_font(cairo_t* cairo, string&& fontname, double offset, double dpi_x, double dpi_y) {
-  static bool fc_init{false};
-  if (!fc_init && !(fc_init = FcInit())) {
+inline FcPattern* match_font(const string& fontname) {
+  static const bool fc_init{FcInit() == FcTrue};
+  if (!fc_init) {
     throw application_error("Could not load fontconfig");
-  } else if (FT_Init_FreeType(&g_ftlib) != FT_Err_Ok) {
-    throw application_error("Could not load FreeType");
   }
 
-  static scope_util::on_exit fc_cleanup([] {
-    FT_Done_FreeType(g_ftlib);
-    FcFini();
-  });
+  static std::mutex cache_mutex;
+  static std::map<string, FcPattern*> cache;
+
+  {
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    auto it = cache.find(fontname);
+    if (it != cache.end()) {
+      FcPatternReference(it->second);
+      return it->second;
+    }
+  }
 
   auto pattern = FcNameParse((FcChar8*)fontname.c_str());
 
@@ -335,8 +354,38 @@ inline decltype(auto) make_font(cairo_t* cairo, string&& fontname, double offset
   FcPatternPrint(match);
 #endif
 
+  std::lock_guard<std::mutex> guard(cache_mutex);
+  auto inserted = cache.emplace(fontname, match);
+  if (!inserted.second) {
+    // Matched concurrently by another thread
+    FcPatternDestroy(match);
+  }
+  FcPatternReference(inserted.first->second);
+  return inserted.first->second;
+}
+
+/**
+ * Create font from a pattern returned by match_font
+ */
+inline decltype(auto) make_font(cairo_t* cairo, FcPattern* match, double offset, double dpi_x, double dpi_y) {
+  if (FT_Init_FreeType(&g_ftlib) != FT_Err_Ok) {
+    throw application_error("Could not load FreeType");
+  }
+
+  static scope_util::on_exit fc_cleanup([] {
+    FT_Done_FreeType(g_ftlib);
+    FcFini();
+  });
+
   return make_shared<font_fc>(cairo, match, offset, dpi_x, dpi_y);
 }
+
+/**
+ * Match and create font from given fontconfig pattern
+ */
+inline decltype(auto) make_font(cairo_t* cairo, string&& fontname, double offset, double dpi_x, double dpi_y) {
+  return make_font(cairo, match_font(fontname), offset, dpi_x, dpi_y);
+}
 } // namespace cairo
 
 POLYBAR_NS_END
@@ -71,6 +71,25 @@ namespace cairo {
       cairo_xcb_surface_set_drawable(m_s, d, w, h);
     }
   };
+
+  /**
+   * @brief Surface in memory
+   */
+  class image_surface : public surface {
+   public:
+    /**
+     * Uses memory owned by the caller
+     */
+    explicit image_surface(unsigned char* data, cairo_format_t format, int w, int h, int stride)
+        : surface(cairo_image_surface_create_for_data(data, format, w, h, stride)) {}
+
+    /**
+     * Allocates the memory, the surface is initially transparent
+     */
+    explicit image_surface(cairo_format_t format, int w, int h) : surface(cairo_image_surface_create(format, w, h)) {}
+
+    ~image_surface() override {}
+  };
 }
 
 POLYBAR_NS_END
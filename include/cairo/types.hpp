@@ -2,13 +2,12 @@
 
 #include <cairo/cairo.h>
 
+#include "cairo/fwd.hpp"
 #include "common.hpp"
 #include "components/types.hpp"
 
 POLYBAR_NS
 
-enum class alignment;
-
 namespace cairo {
   struct point {
     double x;
@@ -62,15 +61,20 @@ namespace cairo {
     double angle_to;
     double radius;
   };
-  struct textblock {
-    alignment align;
-    string contents;
-    int font;
-    rgba bg{};
-    cairo_operator_t bg_operator;
-    rect bg_rect;
-    double* x_advance;
-    double* y_advance;
+  /**
+   * Part of a text that is drawn with a single font
+   */
+  struct text_run {
+    /**
+     * Font the run is drawn with
+     */
+    shared_ptr<font> face;
+    string text;
+    /**
+     * Advance of the run, rounded up to whole pixels
+     */
+    double x_advance;
+    double y_advance;
   };
 }  // namespace cairo
 
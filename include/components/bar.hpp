@@ -33,8 +33,7 @@ class dispatch;
 // }}}
 
 class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::property_notify, evt::enter_notify,
-                evt::leave_notify, evt::motion_notify, evt::destroy_notify, evt::client_message, evt::configure_notify>,
-            public signal_receiver<SIGN_PRIORITY_BAR, signals::ui::dim_window> {
+                evt::leave_notify, evt::motion_notify, evt::destroy_notify, evt::client_message, evt::configure_notify> {
  public:
   using make_type = unique_ptr<bar>;
   static make_type make(eventloop::loop&, const config&, bool only_initialize_values = false);
@@ -47,7 +46,7 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
 
   void start(const string& tray_module_name);
 
-  void parse(string&& data, bool force = false);
+  void parse(shared_ptr<const string> data, bool force = false);
 
   void hide();
   void show();
@@ -64,6 +63,8 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
 
   void map_window();
 
+  void defer_frame();
+
   void trigger_click(mousebtn btn, int pos);
 
   void handle(const evt::client_message& evt) override;
@@ -76,7 +77,7 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
   void handle(const evt::property_notify& evt) override;
   void handle(const evt::configure_notify& evt) override;
 
-  bool on(const signals::ui::dim_window&) override;
+  void dim(double value);
 
 #if WITH_XCURSOR
   /**
@@ -85,6 +86,11 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
    * The cursor name must be valid (cursor_util::valid)
    */
   void change_cursor(const string& name);
+
+  /**
+   * Update the cursor for the pointer being at the given x-position.
+   */
+  void update_cursor(int pos);
 #endif
 
  private:
@@ -106,7 +112,7 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
    */
   string m_cursor{};
 
-  string m_lastinput{};
+  shared_ptr<const string> m_lastinput{std::make_shared<const string>()};
   std::set<mousebtn> m_dblclicks;
 
   eventloop::timer_handle_t m_leftclick_timer{m_loop.handle<eventloop::TimerHandle>()};
@@ -114,7 +120,25 @@ class bar : public xpp::event::sink<evt::button_press, evt::expose, evt::propert
   eventloop::timer_handle_t m_rightclick_timer{m_loop.handle<eventloop::TimerHandle>()};
   eventloop::timer_handle_t m_dim_timer{m_loop.handle<eventloop::TimerHandle>()};
 
+  /**
+   * Defers cursor updates to the next loop iteration so that a burst of motion
+   * events only causes a single lookup for the latest position.
+   */
+  eventloop::timer_handle_t m_motion_timer{m_loop.handle<eventloop::TimerHandle>()};
+  /**
+   * Redraws deferred contents if the frame in flight is dropped instead of shown
+   */
+  eventloop::timer_handle_t m_frame_timer{m_loop.handle<eventloop::TimerHandle>()};
+  int m_motion_pos{0};
+
   bool m_visible{true};
+
+  /**
+   * Contents arrived while the renderer was waiting for the last frame to be shown
+   *
+   * The latest contents are rendered once the frame was shown or dropped.
+   */
+  bool m_frame_deferred{false};
 };
 
 POLYBAR_NS_END
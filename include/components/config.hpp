@@ -1,5 +1,6 @@
 #pragma once
 
+#include <set>
 #include <unordered_map>
 
 #include "common.hpp"
@@ -41,10 +42,37 @@ class config {
 
   void set_included(file_list included);
 
+  /**
+   * @brief Copy of this config for another bar defined in the same config file
+   *
+   * @throws application_error If there is no such bar
+   */
+  config with_bar(string barname) const;
+
   file_list get_included_files() const;
 
   void warn_deprecated(const string& section, const string& key, string replacement = "") const;
 
+  /**
+   * Returns true if the values of a section differ from the ones in another
+   * configuration.
+   *
+   * Besides the section itself, all values it references through
+   * ${section.key} (directly or indirectly) are compared as well. Keys in
+   * ignored_keys, and whatever they reference, are skipped.
+   *
+   * References to the environment, the X resource database and files are not
+   * followed.
+   */
+  bool section_changed(const config& other, const string& section, const std::set<string>& ignored_keys = {}) const;
+
+  /**
+   * Returns true if any value of the section references the bar section, directly or indirectly.
+   *
+   * The values of such sections may differ between bars.
+   */
+  bool depends_on_bar(const string& section) const;
+
   /**
    * Returns true if a given parameter exists
    */
@@ -232,6 +260,18 @@ class config {
    */
   string dereference_local(string section, const string& key, const string& current_section) const;
 
+  /**
+   * Resolve the section and key a local reference points to
+   *
+   * @return false if value isn't a local reference
+   */
+  bool parse_local_reference(const string& current_section, const string& value, string& section, string& key) const;
+
+  /**
+   * Raw value of a parameter, nullptr if it doesn't exist
+   */
+  const string* find_raw(const string& section, const string& key) const;
+
   /**
    * Dereference environment variable reference defined using:
    *  ${env:key}
@@ -265,7 +305,7 @@ class config {
    */
   file_list m_included;
 #if WITH_XRM
-  unique_ptr<xresource_manager> m_xrm;
+  shared_ptr<xresource_manager> m_xrm;
 #endif
 };
 
@@ -2,6 +2,7 @@
 
 #include <mutex>
 #include <queue>
+#include <unordered_map>
 
 #include "common.hpp"
 #include "components/eventloop.hpp"
@@ -35,18 +36,21 @@ using modulemap_t = std::map<alignment, vector<module_t>>;
 
 class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eventqueue::exit_reload,
                        signals::eventqueue::notify_change, signals::eventqueue::notify_forcechange,
-                       signals::eventqueue::check_state, signals::ipc::action, signals::ipc::command,
-                       signals::ipc::hook, signals::ui::button_press, signals::ui::update_background> {
+                       signals::eventqueue::check_state, signals::ipc::action, signals::ipc::batch,
+                       signals::ipc::command, signals::ipc::hook, signals::ui::button_press,
+                       signals::ui::update_background> {
  public:
   using make_type = unique_ptr<controller>;
-  static make_type make(bool has_ipc, eventloop::loop&, const config&);
+  static make_type make(bool has_ipc, eventloop::loop&, const vector<config>& confs);
 
-  explicit controller(connection&, signal_emitter&, const logger&, const config&, bool has_ipc, eventloop::loop&);
+  explicit controller(
+      connection&, signal_emitter&, const logger&, const vector<config>& confs, bool has_ipc, eventloop::loop&);
   ~controller();
 
   bool run(bool writeback, string snapshot_dst, bool confwatch);
 
-  void trigger_action(string&& input_data);
+  void trigger_action(string&& input_data, const bar* source = nullptr);
+  void trigger_actions(vector<string>&& actions);
   void trigger_quit(bool reload);
   void trigger_update(bool force);
 
@@ -63,8 +67,11 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
  protected:
   void trigger_notification();
   void start_modules();
+  bool start_module(const module_t& module);
+  void watch_config_files();
+  bool reload_config();
   void read_events(bool confwatch);
-  void process_inputdata(string&& cmd);
+  void process_inputdata(string&& cmd, const bar* source);
   bool process_update(bool force);
 
   void update_reload(bool reload);
@@ -75,6 +82,7 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
   bool on(const signals::eventqueue::check_state& evt) override;
   bool on(const signals::ui::button_press& evt) override;
   bool on(const signals::ipc::action& evt) override;
+  bool on(const signals::ipc::batch& evt) override;
   bool on(const signals::ipc::command& evt) override;
   bool on(const signals::ipc::hook& evt) override;
   bool on(const signals::ui::update_background& evt) override;
@@ -85,14 +93,53 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
     bool reload;
     bool update;
     bool force_update;
-    queue<string> inputdata;
+    queue<pair<const bar*, string>> inputdata;
 
-    notifications_t() : quit(false), reload(false), update(false), force_update(false), inputdata(queue<string>{}) {}
+    notifications_t()
+        : quit(false), reload(false), update(false), force_update(false), inputdata(queue<pair<const bar*, string>>{}) {}
   };
 
-  size_t setup_modules(alignment align);
+  /**
+   * @brief A bar and the modules displayed on it
+   */
+  struct hosted_bar {
+    hosted_bar(const config& conf, unique_ptr<polybar::bar>&& bar);
+
+    bool shows(const module_t& module) const;
+
+    const config& conf;
+    unique_ptr<polybar::bar> bar;
+    modulemap_t blocks;
+    string tray_module_name;
+
+    /**
+     * Generation of every module that was displayed in the last update
+     *
+     * Blocks are separated by an entry without module.
+     */
+    vector<pair<const modules::module_interface*, size_t>> generations;
+  };
+
+  /**
+   * @brief Module to be created for a bar
+   */
+  struct module_request {
+    string name;
+    const bar_settings& bar;
+    const config& conf;
+  };
+
+  size_t setup_modules();
+  vector<module_t> create_modules(const vector<module_request>& requests);
+  module_t create_module(const string& name, const bar_settings& bar, const config& conf);
+
+  shared_ptr<const string> bar_contents(hosted_bar& target, bool force) const;
+
+  const config& current_config() const;
 
-  bool forward_action(const actions_util::action& cmd);
+  static void coalesce_events(vector<shared_ptr<xcb_generic_event_t>>& events);
+
+  bool forward_action(const actions_util::action& cmd, const bar* source);
   bool try_forward_legacy_action(const string& cmd);
 
   connection& m_connection;
@@ -100,9 +147,14 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
   const logger& m_log;
   const config& m_conf;
   eventloop::loop& m_loop;
-  unique_ptr<bar> m_bar;
   bool m_has_ipc;
-  string m_tray_module_name;
+
+  /**
+   * @brief All bars hosted in this process
+   *
+   * The first bar is the one of the main config (m_conf).
+   */
+  vector<hosted_bar> m_bars;
 
   /**
    * @brief Async handle to notify the eventloop
@@ -126,6 +178,13 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
    */
   std::mutex m_notification_mutex{};
 
+  /**
+   * Whether notifier_handler() is emitting posted signals
+   *
+   * Notifications added in the meantime are processed afterwards in the same call. Protected by m_notification_mutex.
+   */
+  bool m_dispatching_posted{false};
+
   /**
    * @brief Destination path of generated snapshot
    */
@@ -138,18 +197,51 @@ class controller : public signal_receiver<SIGN_PRIORITY_CONTROLLER, signals::eve
 
   /**
    * @brief Loaded modules
+   *
+   * Modules shared between multiple bars are only contained once.
    */
   vector<module_t> m_modules;
 
   /**
-   * @brief Loaded modules grouped by block
+   * @brief Most recently reloaded config
+   *
+   * Empty as long as the config passed to the constructor is in use.
+   */
+  shared_ptr<const config> m_reloaded_conf;
+
+  /**
+   * @brief Configs of modules created while reloading the config
+   *
+   * Modules keep a reference to the config they were created with, it must stay alive as long as the module does.
    */
-  modulemap_t m_blocks;
+  std::unordered_map<const modules::module_interface*, shared_ptr<const config>> m_module_confs;
+
+  /**
+   * @brief Watchers for the config file and its included files
+   */
+  std::map<string, shared_ptr<eventloop::FSEventHandle>> m_config_watchers;
 
   /**
    * @brief Flag to trigger reload after shutdown
    */
   bool m_reload{false};
+
+  /**
+   * @brief X events drained from the connection, waiting to be dispatched
+   *
+   * Kept as a member so that its storage is reused between loop iterations.
+   */
+  vector<shared_ptr<xcb_generic_event_t>> m_event_batch;
+
+  /**
+   * @brief Number of X events received from the connection
+   */
+  size_t m_num_raw_events{0};
+
+  /**
+   * @brief Number of X events dispatched after coalescing
+   */
+  size_t m_num_dispatched_events{0};
 };
 
 POLYBAR_NS_END
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
 #include <map>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
 
 #include "common.hpp"
 #include "settings.hpp"
+#include "utils/ring_buffer.hpp"
 
 #ifndef STDOUT_FILENO
 #define STDOUT_FILENO 1
@@ -33,6 +37,7 @@ class logger {
   static make_type make(loglevel level = loglevel::NONE);
 
   explicit logger(loglevel level);
+  ~logger();
 
   const logger& operator=(const logger&) const {
     return *this;
@@ -42,6 +47,8 @@ class logger {
 
   void verbosity(loglevel level);
 
+  void flush() const;
+
 #ifdef DEBUG_LOGGER // {{{
   template <typename... Args>
   void trace(const string& message, Args&&... args) const {
@@ -113,8 +120,10 @@ class logger {
   size_t convert(std::thread::id arg) const;
 
   /**
-   * Write the log message to the output channel
+   * Format the log message and pass it to the output channel
    * if the defined verbosity level allows it
+   *
+   * Only the formatting happens on the calling thread, the message is written by a background thread.
    */
   template <typename... Args>
   void output(loglevel level, const string& format, Args&&... values) const {
@@ -122,6 +131,10 @@ class logger {
       return;
     }
 
+    string fmt{m_prefixes.at(level) + format + m_suffixes.at(level) + "\n"};
+    char buf[512];
+    string message;
+
 #if defined(__clang__) // {{{
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wformat-security"
@@ -130,15 +143,27 @@ class logger {
 #pragma GCC diagnostic ignored "-Wformat-security"
 #endif // }}}
 
-    dprintf(m_fd, (m_prefixes.at(level) + format + m_suffixes.at(level) + "\n").c_str(), convert(values)...);
+    int size = snprintf(buf, sizeof(buf), fmt.c_str(), convert(values)...);
+    if (size < 0) {
+      return;
+    } else if (static_cast<size_t>(size) < sizeof(buf)) {
+      message.assign(buf, size);
+    } else {
+      message.resize(size);
+      snprintf(&message[0], size + 1, fmt.c_str(), convert(values)...);
+    }
 
 #if defined(__clang__) // {{{
 #pragma clang diagnostic pop
 #elif defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif // }}}
+
+    enqueue(level, move(message));
   }
 
+  void enqueue(loglevel level, string&& message) const;
+
  private:
   /**
    * Logger verbosity level
@@ -159,6 +184,34 @@ class logger {
    * Loglevel specific suffixes
    */
   std::map<loglevel, string> m_suffixes;
+
+  void run_flusher() const;
+  void drain() const;
+  void write_all(const string& data) const;
+
+  /**
+   * Formatted messages waiting to be written
+   */
+  mutable ring_buffer<string> m_queue{4096};
+
+  /**
+   * Number of messages dropped because the queue was full
+   */
+  mutable std::atomic<size_t> m_dropped{0};
+
+  /**
+   * Background thread writing the queued messages, started with the first message
+   */
+  mutable std::thread m_flusher;
+  mutable std::once_flag m_flusher_started;
+  mutable std::mutex m_flusher_mutex;
+  mutable std::condition_variable m_flusher_cv;
+  mutable bool m_stopped{false};
+
+  /**
+   * Held while writing, keeps messages in order if multiple threads drain the queue
+   */
+  mutable std::mutex m_write_mutex;
 };
 
 POLYBAR_NS_END
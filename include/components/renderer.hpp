@@ -3,14 +3,18 @@
 #include <cairo/cairo.h>
 
 #include <bitset>
+#include <chrono>
+#include <functional>
 #include <memory>
 
 #include "cairo/fwd.hpp"
+#include "cairo/types.hpp"
 #include "common.hpp"
 #include "components/renderer_interface.hpp"
 #include "components/types.hpp"
 #include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
+#include "settings.hpp"
 #include "x11/extensions/fwd.hpp"
 #include "x11/types.hpp"
 
@@ -22,12 +26,41 @@ class config;
 class logger;
 class background_manager;
 class bg_slice;
+class shm_image;
+class present_window;
+namespace concurrency_util {
+  class worker_pool;
+}
 // }}}
 
 using std::map;
 
+/**
+ * Text or offset in an alignment block
+ *
+ * Elements are recorded while the block is measured and drawn once the position of the block is known.
+ */
+struct block_element {
+  /**
+   * Position relative to the start of the block
+   */
+  double x{0.0};
+  double width{0.0};
+  /**
+   * Text drawn in the foreground color, empty for offsets
+   */
+  vector<cairo::text_run> runs{};
+  rgba fg{};
+  rgba bg{};
+  rgba ul{};
+  rgba ol{};
+  bool has_bg{false};
+  bool has_ul{false};
+  bool has_ol{false};
+};
+
 struct alignment_block {
-  cairo_pattern_t* pattern;
+  vector<block_element> elements;
   /**
    * The x-position where the next thing will be rendered.
    */
@@ -42,8 +75,19 @@ struct alignment_block {
   double width;
 };
 
+/**
+ * Surface an alignment block is drawn onto if blocks are drawn in parallel
+ *
+ * The layer has the size of the whole bar, so the block is drawn at the same coordinates as on the bar.
+ */
+struct block_layer {
+  unique_ptr<cairo::image_surface> surface;
+  unique_ptr<cairo::context> context;
+};
+
 class renderer : public renderer_interface,
-                 public signal_receiver<SIGN_PRIORITY_RENDERER, signals::ui::request_snapshot> {
+                 public signal_receiver<SIGN_PRIORITY_RENDERER, signals::ui::request_snapshot,
+                     signals::ui::update_background, signals::ui::x_generic_event> {
  public:
   using make_type = unique_ptr<renderer>;
   static make_type make(const bar_settings& bar, tags::action_context& action_ctxt, const config&);
@@ -60,6 +104,24 @@ class renderer : public renderer_interface,
   void end();
   void flush();
 
+  /**
+   * Whether the last frame is still waiting to be shown
+   *
+   * The case while the X server still reads the frame from shared memory or while a frame synchronized to the monitor
+   * (vsync) was not shown yet. No new frame may be started until then.
+   */
+  bool busy();
+
+  /**
+   * Time after which a frame that was not shown is dropped, busy() is false again afterwards
+   */
+  std::chrono::milliseconds frame_timeout() const;
+
+  /**
+   * Sets the function that is called when the renderer is no longer busy after a frame was shown
+   */
+  void on_frame_presented(std::function<void()>&& callback);
+
   void render_offset(const tags::context& ctxt, const extent_val offset) override;
   void render_text(const tags::context& ctxt, const string&&) override;
 
@@ -72,23 +134,34 @@ class renderer : public renderer_interface,
   void apply_tray_position(const tags::context& context) override;
 
  protected:
-  void fill_background();
-  void fill_overline(rgba color, double x, double w);
-  void fill_underline(rgba color, double x, double w);
+  void fill_background(cairo::context& ctxt);
+  void fill_area(cairo::context& ctxt, rgba color, const cairo::rect& area, bool layer);
+  void fill_overline(cairo::context& ctxt, rgba color, double x, double w);
+  void fill_underline(cairo::context& ctxt, rgba color, double x, double w);
   void fill_borders();
-  void draw_offset(const tags::context& ctxt, rgba color, double x, double w);
+  void clip_inner_area();
+  void update_base_layer();
+  void free_base_layer();
+  void add_element(block_element&& element);
 
   double block_x(alignment a) const;
   double block_y(alignment a) const;
   double block_w(alignment a) const;
   double block_h(alignment a) const;
+  cairo::rect block_area(alignment a) const;
 
   void increase_x(double dx);
 
-  void flush(alignment a);
+  void draw_elements(cairo::context& ctxt, alignment a, double x, bool layer);
+  void draw_layer(alignment a);
+  void paint_block(alignment a);
+  void present();
+  void add_damage(const xcb_rectangle_t& area);
   void highlight_clickable_areas();
 
   bool on(const signals::ui::request_snapshot& evt) override;
+  bool on(const signals::ui::update_background& evt) override;
+  bool on(const signals::ui::x_generic_event& evt) override;
 
  protected:
   struct reserve_area {
@@ -113,17 +186,59 @@ class renderer : public renderer_interface,
   /**
    * Background pixmap for the bar window
    *
-   * All bar contents are rendered onto this.
+   * All bar contents are rendered onto this, unless they are rendered into shared memory.
    */
-  xcb_pixmap_t m_pixmap;
+  xcb_pixmap_t m_pixmap{XCB_NONE};
+
+#if WITH_XSHM
+  /**
+   * Shared memory image the bar is rendered into, if the X server supports it
+   */
+  unique_ptr<shm_image> m_shm;
+#endif
+
+#if WITH_XPRESENT
+  /**
+   * Shows the pixmap at the vertical blank of the monitor, if vsync is enabled
+   */
+  unique_ptr<present_window> m_present;
+#endif
+  std::function<void()> m_frame_presented;
 
   xcb_rectangle_t m_rect{0, 0, 0U, 0U};
   reserve_area m_cleararea{};
 
+  /**
+   * Area that was drawn since the bar was last presented
+   *
+   * Only the alignment blocks differ between two renders of the same geometry, so this is the area covered by the
+   * blocks of the current and the previous render.
+   */
+  xcb_rectangle_t m_damage{0, 0, 0U, 0U};
+  bool m_full_damage{true};
+  vector<xcb_rectangle_t> m_block_areas;
+  vector<xcb_rectangle_t> m_prev_block_areas;
+
   unique_ptr<cairo::context> m_context;
-  unique_ptr<cairo::xcb_surface> m_surface;
+  unique_ptr<cairo::surface> m_surface;
   map<alignment, alignment_block> m_blocks;
-  cairo_pattern_t* m_cornermask{};
+
+  /**
+   * Threads and layers used to draw the alignment blocks in parallel, if enabled
+   */
+  unique_ptr<concurrency_util::worker_pool> m_workers;
+  map<alignment, block_layer> m_layers;
+
+  /**
+   * Pre-composited layers used for pseudo-transparency
+   *
+   * m_underlay is the desktop background with the borders on top, m_base
+   * additionally has the bar background on top. Both are only rebuilt if the
+   * desktop background or the bar geometry changes.
+   */
+  cairo_pattern_t* m_underlay{};
+  cairo_pattern_t* m_base{};
+  xcb_rectangle_t m_base_rect{0, 0, 0U, 0U};
 
   cairo_operator_t m_comp_bg{CAIRO_OPERATOR_SOURCE};
   cairo_operator_t m_comp_fg{CAIRO_OPERATOR_OVER};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "common.hpp"
+#include "utils/time.hpp"
+
+POLYBAR_NS
+
+class logger;
+
+/**
+ * @brief Collects the timings of the startup phases (--profile-startup)
+ *
+ * Timers can be started from any thread, phases that run on worker threads are recorded together with the thread
+ * they ran on.
+ */
+class startup_profiler {
+ public:
+  using make_type = startup_profiler&;
+  static make_type make();
+
+  /**
+   * @brief Measures the duration of a phase from construction to destruction
+   */
+  class timer {
+   public:
+    timer(startup_profiler& profiler, string&& name);
+    ~timer();
+
+   private:
+    startup_profiler& m_profiler;
+    string m_name;
+    time_util::clock_t::time_point m_start;
+  };
+
+  startup_profiler();
+
+  void enable();
+  bool enabled() const;
+
+  /**
+   * @brief Starts measuring a phase
+   *
+   * Nothing is recorded if profiling is disabled or the profile was already reported.
+   */
+  unique_ptr<timer> start(string&& name);
+
+  /**
+   * @brief Logs all recorded phases in the order they were started
+   *
+   * Only the first call produces output.
+   */
+  void report(const logger& log);
+
+ protected:
+  void record(string&& name, time_util::clock_t::time_point start, time_util::clock_t::time_point end);
+
+ private:
+  struct entry {
+    string name;
+    time_util::clock_t::time_point start;
+    time_util::clock_t::time_point end;
+    size_t thread;
+  };
+
+  std::atomic<bool> m_enabled{false};
+  std::atomic<bool> m_reported{false};
+  time_util::clock_t::time_point m_begin;
+  std::mutex m_mutex;
+  vector<entry> m_entries;
+};
+
+POLYBAR_NS_END
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 
 #include "common.hpp"
 #include "drawtypes/label.hpp"
@@ -18,6 +19,40 @@ namespace drawtypes {
 
    protected:
     std::map<string, label_t> m_icons;
+
+   private:
+    using icon_entry = std::map<string, label_t>::value_type;
+
+    /**
+     * Node of the Aho-Corasick automaton over all icon ids
+     */
+    struct index_node {
+      std::map<char, size_t> children{};
+      /**
+       * Node for the longest proper suffix of this node's text that is also in the automaton
+       */
+      size_t fail{0};
+      /**
+       * Longest icon id that is a suffix of this node's text
+       */
+      const icon_entry* match{nullptr};
+    };
+
+    void build_index();
+    const icon_entry* find_longest_match(const string& id);
+
+    /**
+     * Automaton used for fuzzy matching, the root is at index 0.
+     *
+     * Built on the first fuzzy lookup after an icon was added.
+     */
+    vector<index_node> m_index;
+    bool m_index_valid{false};
+
+    /**
+     * Results of fuzzy lookups per id, cleared whenever an icon is added
+     */
+    std::unordered_map<string, label_t> m_fuzzy_matches;
   };
 
   using iconset_t = shared_ptr<iconset>;
@@ -19,6 +19,41 @@ namespace drawtypes {
     bool rpadding{false};
   };
 
+  /**
+   * Label text compiled into a sequence of literal text and token slots
+   *
+   * The text is only parsed once, when the label is created, and the template is shared by all clones of the label.
+   * Replacing a token only stores the value of its slot, the text is assembled in label::get.
+   */
+  class label_template : public non_copyable_mixin {
+   public:
+    struct segment {
+      /**
+       * Literal text or, for slots, the token itself, which is shown as long as no value is set
+       */
+      string text;
+      /**
+       * Index of the slot's token in tokens() or -1 for literal text
+       */
+      int slot{-1};
+    };
+
+    explicit label_template(const string& text, vector<token>&& tokens);
+
+    const vector<segment>& segments() const;
+    const vector<token>& tokens() const;
+    size_t size() const;
+
+   private:
+    vector<segment> m_segments;
+    const vector<token> m_tokens;
+
+    /**
+     * Size of the text in bytes if no token is replaced
+     */
+    size_t m_size{0};
+  };
+
   class label : public non_copyable_mixin {
    public:
     rgba m_foreground{};
@@ -41,11 +76,16 @@ namespace drawtypes {
     alignment m_alignment{alignment::LEFT};
     bool m_ellipsis{true};
 
-    explicit label(string text, int font) : m_font(font), m_text(move(text)), m_tokenized(m_text) {}
+    explicit label(string text, int font) : label(move(text), rgba{}, rgba{}, rgba{}, rgba{}, font) {}
     explicit label(string text, rgba foreground = rgba{}, rgba background = rgba{}, rgba underline = rgba{},
         rgba overline = rgba{}, int font = 0, side_values padding = {ZERO_SPACE, ZERO_SPACE},
         side_values margin = {ZERO_SPACE, ZERO_SPACE}, int minlen = 0, size_t maxlen = 0_z,
         alignment label_alignment = alignment::LEFT, bool ellipsis = true, vector<token>&& tokens = {})
+        : label(std::make_shared<const label_template>(text, forward<vector<token>>(tokens)), foreground, background,
+              underline, overline, font, padding, margin, minlen, maxlen, label_alignment, ellipsis) {}
+    explicit label(shared_ptr<const label_template> tmpl, rgba foreground, rgba background, rgba underline,
+        rgba overline, int font, side_values padding, side_values margin, size_t minlen, size_t maxlen,
+        alignment label_alignment, bool ellipsis)
         : m_foreground(move(foreground))
         , m_background(move(background))
         , m_underline(move(underline))
@@ -57,27 +97,40 @@ namespace drawtypes {
         , m_maxlen(maxlen)
         , m_alignment(label_alignment)
         , m_ellipsis(ellipsis)
-        , m_text(move(text))
-        , m_tokenized(m_text)
-        , m_tokens(forward<vector<token>>(tokens)) {
+        , m_template(move(tmpl))
+        , m_values(m_template->tokens().size()) {
       assert(!m_ellipsis || (m_maxlen == 0 || m_maxlen >= 3));
     }
 
     string get() const;
-    explicit operator bool();
+    explicit operator bool() const;
     label_t clone();
     void clear();
     void reset_tokens();
-    void reset_tokens(const string& tokenized);
     bool has_token(const string& token) const;
     void replace_token(const string& token, string replacement);
     void replace_defined_values(const label_t& label);
     void copy_undefined(const label_t& label);
 
    private:
-    string m_text{};
-    string m_tokenized{};
-    const vector<token> m_tokens{};
+    string text() const;
+
+    struct slot_value {
+      string value;
+      bool set{false};
+    };
+
+    shared_ptr<const label_template> m_template;
+
+    /**
+     * Values of the template's token slots, indexed like label_template::tokens
+     */
+    vector<slot_value> m_values;
+
+    /**
+     * Set by clear(), the label is empty until the tokens are reset
+     */
+    bool m_cleared{false};
   };
 
   label_t load_label(const config& conf, const string& section, string name, bool required = true, string def = ""s);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "common.hpp"
 #include "components/builder.hpp"
 #include "components/config.hpp"
@@ -26,6 +28,15 @@ namespace drawtypes {
 
    private:
     unique_ptr<builder> m_builder;
+
+    /**
+     * Built output per state of the bar
+     *
+     * The output only depends on the fill width and, without gradient, the fill color, so there are only a few distinct
+     * states. The cache is cleared whenever one of the icons or colors is changed.
+     */
+    std::unordered_map<unsigned int, string> m_cache;
+
     vector<rgba> m_colors;
     string m_format;
     unsigned int m_width;
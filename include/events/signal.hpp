@@ -5,6 +5,8 @@
 
 POLYBAR_NS
 
+class bar;
+
 namespace signals {
   namespace detail {
     class signal {
@@ -72,22 +74,34 @@ namespace signals {
     struct action : public detail::value_signal<action, string> {
       using base_type::base_type;
     };
+    /// emitted with multiple actions that should be applied before the next redraw
+    struct batch : public detail::value_signal<batch, vector<string>> {
+      using base_type::base_type;
+    };
   } // namespace ipc
 
   namespace ui {
     struct changed : public detail::base_signal<changed> {
       using base_type::base_type;
     };
-    struct button_press : public detail::value_signal<button_press, string> {
+    /// emitted with the bar that was clicked and the triggered input
+    struct button_press : public detail::value_signal<button_press, std::pair<const bar*, string>> {
+      using base_type::base_type;
+    };
+    /// emitted with the window of the bar that was shown or hidden and whether it is visible now
+    struct visibility_change : public detail::value_signal<visibility_change, std::pair<xcb_window_t, bool>> {
       using base_type::base_type;
     };
-    struct visibility_change : public detail::value_signal<visibility_change, bool> {
+    /// emitted with the module name and the new contents whenever the output of a module changes
+    struct module_output : public detail::value_signal<module_output, std::pair<string, string>> {
       using base_type::base_type;
     };
-    struct dim_window : public detail::value_signal<dim_window, double> {
+    /// emitted with the window of the bar that was dimmed and its new opacity
+    struct dim_window : public detail::value_signal<dim_window, std::pair<xcb_window_t, double>> {
       using base_type::base_type;
     };
-    struct request_snapshot : public detail::value_signal<request_snapshot, string> {
+    /// emitted with the window of the bar whose next frame is saved and the destination file
+    struct request_snapshot : public detail::value_signal<request_snapshot, std::pair<xcb_window_t, string>> {
       using base_type::base_type;
     };
     /// emitted whenever the desktop background slice changes
@@ -98,10 +112,20 @@ namespace signals {
     struct update_geometry : public detail::base_signal<update_geometry> {
       using base_type::base_type;
     };
+    /// emitted with the error code and the bad resource id for errors of unchecked X requests
+    struct x_error : public detail::value_signal<x_error, std::pair<uint8_t, uint32_t>> {
+      using base_type::base_type;
+    };
+    /// emitted for X events of extensions that are not known to the event registry (generic events and the like), the
+    /// event is only valid during the emission
+    struct x_generic_event : public detail::value_signal<x_generic_event, const xcb_generic_event_t*> {
+      using base_type::base_type;
+    };
   } // namespace ui
 
   namespace ui_tray {
-    struct tray_pos_change : public detail::value_signal<tray_pos_change, int> {
+    /// emitted with the window of the bar and the new x position of its tray
+    struct tray_pos_change : public detail::value_signal<tray_pos_change, std::pair<xcb_window_t, int>> {
       using base_type::base_type;
     };
   } // namespace ui_tray
@@ -1,19 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
 #include "common.hpp"
 #include "components/logger.hpp"
+#include "events/signal_fwd.hpp"
 #include "events/signal_receiver.hpp"
 
 POLYBAR_NS
 
-/**
- * @brief Holds all signal receivers attached to the emitter
- */
-extern signal_receivers_t g_signal_receivers;
-
 /**
  * Wrapper used to delegate emitted signals
  * to attached signal receivers
+ *
+ * Each signal type has its own slot holding the receivers of that signal, sorted by priority. Signals are emitted on
+ * the thread running the eventloop, other threads queue them with post().
  */
 class signal_emitter {
  public:
@@ -23,14 +28,26 @@ class signal_emitter {
   explicit signal_emitter() = default;
   virtual ~signal_emitter() {}
 
+  /**
+   * Passes the signal to the receivers in order of their priority until one of them handles it
+   *
+   * Must only be called from the eventloop thread. Receivers attached or detached while the signal is handled only
+   * take part in the next emission.
+   *
+   * @returns true if a receiver handled the signal
+   */
   template <typename Signal>
   bool emit(const Signal& sig) {
+    auto receivers = m_receivers[signals::slot<Signal>()];
+
+    if (!receivers) {
+      return false;
+    }
+
     try {
-      if (g_signal_receivers.find(id<Signal>()) != g_signal_receivers.end()) {
-        for (auto&& item : g_signal_receivers.at(id<Signal>())) {
-          if (item.second->on(sig)) {
-            return true;
-          }
+      for (const auto& item : *receivers) {
+        if (static_cast<signal_receiver_impl<Signal>*>(item.sink)->on(sig)) {
+          return true;
         }
       }
     } catch (const std::exception& e) {
@@ -45,63 +62,112 @@ class signal_emitter {
     return emit<Signal>(sig) || emit<Next, Signals...>(sig);
   }
 
+  /**
+   * Queues the signal to be emitted on the eventloop thread
+   *
+   * Can be called from any thread. Only signals without data can be posted, the signal is default constructed when it
+   * is emitted. A signal that is posted again before it was emitted is only emitted once.
+   */
+  template <typename Signal>
+  void post() {
+    if (m_posted[signals::slot<Signal>()].exchange(&signal_emitter::emit_posted<Signal>) != nullptr) {
+      // Already queued, the eventloop was woken up for it
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_wakeup_lock);
+    if (m_wakeup) {
+      m_wakeup();
+    }
+  }
+
+  /**
+   * Sets the function that wakes up the eventloop after a signal was posted
+   *
+   * The eventloop then has to call dispatch_posted().
+   */
+  void set_wakeup(std::function<void()>&& wakeup);
+
+  /**
+   * Emits all signals queued with post()
+   *
+   * Signals are emitted in the order of their slots, not in the order they were posted in.
+   */
+  void dispatch_posted();
+
   template <int Priority, typename Signal, typename... Signals>
   void attach(signal_receiver<Priority, Signal, Signals...>* s) {
-    attach<signal_receiver<Priority, Signal, Signals...>, Signal, Signals...>(s);
+    attach<Signal>(Priority, s);
+    (attach<Signals>(Priority, s), ...);
   }
 
   template <int Priority, typename Signal, typename... Signals>
   void detach(signal_receiver<Priority, Signal, Signals...>* s) {
-    detach<signal_receiver<Priority, Signal, Signals...>, Signal, Signals...>(s);
+    detach<Signal>(s);
+    (detach<Signals>(s), ...);
   }
 
  protected:
-  template <typename Signal>
-  std::type_index id() const {
-    return typeid(Signal);
-  }
+  struct receiver {
+    int priority;
+    /**
+     * Points to a signal_receiver_impl of the signal of the slot
+     */
+    void* sink;
+  };
 
-  template <typename Receiver, typename Signal>
-  void attach(Receiver* s) {
-    attach(s, id<Signal>());
-  }
+  using receiver_list = vector<receiver>;
+  using emit_fn = bool (*)(signal_emitter&);
 
-  template <typename Receiver, typename Signal, typename Next, typename... Signals>
-  void attach(Receiver* s) {
-    attach(s, id<Signal>());
-    attach<Receiver, Next, Signals...>(s);
+  template <typename Signal>
+  static bool emit_posted(signal_emitter& emitter) {
+    return emitter.emit(Signal{});
   }
 
-  void attach(signal_receiver_interface* s, std::type_index id) {
-    g_signal_receivers[id].emplace(s->priority(), s);
+  /**
+   * Inserts the receiver after all receivers with the same or a lower priority value
+   */
+  template <typename Signal>
+  void attach(int priority, signal_receiver_impl<Signal>* s) {
+    auto& slot = m_receivers[signals::slot<Signal>()];
+    auto receivers = slot ? *slot : receiver_list{};
+    auto pos = std::upper_bound(receivers.begin(), receivers.end(), priority,
+        [](int prio, const receiver& item) { return prio < item.priority; });
+    receivers.insert(pos, receiver{priority, s});
+    slot = make_shared<const receiver_list>(move(receivers));
   }
 
-  template <typename Receiver, typename Signal>
-  void detach(Receiver* s) {
-    detach(s, id<Signal>());
-  }
+  template <typename Signal>
+  void detach(signal_receiver_impl<Signal>* s) {
+    auto& slot = m_receivers[signals::slot<Signal>()];
+    if (!slot) {
+      return;
+    }
 
-  template <typename Receiver, typename Signal, typename Next, typename... Signals>
-  void detach(Receiver* s) {
-    detach(s, id<Signal>());
-    detach<Receiver, Next, Signals...>(s);
+    auto receivers = *slot;
+    receivers.erase(std::remove_if(receivers.begin(), receivers.end(),
+                        [s](const receiver& item) { return item.sink == static_cast<void*>(s); }),
+        receivers.end());
+    slot = make_shared<const receiver_list>(move(receivers));
   }
 
-  void detach(signal_receiver_interface* d, std::type_index id) {
-    try {
-      auto& prio_map = g_signal_receivers.at(id);
-      const auto& prio_sink_pair = prio_map.equal_range(d->priority());
-
-      for (auto it = prio_sink_pair.first; it != prio_sink_pair.second;) {
-        if (d == it->second) {
-          it = prio_map.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } catch (...) {
-    }
-  }
+  /**
+   * Receivers of each signal, indexed by signals::slot
+   *
+   * The lists are never modified, attaching or detaching a receiver replaces the list of the slot. This way, emit()
+   * can iterate over a list while one of the receivers attaches or detaches another one.
+   */
+  std::array<shared_ptr<const receiver_list>, signals::all::size> m_receivers{};
+
+  /**
+   * Signals posted from other threads that were not emitted yet, indexed by signals::slot
+   *
+   * A slot holds the function that emits its signal while the signal is queued and nullptr otherwise.
+   */
+  std::array<std::atomic<emit_fn>, signals::all::size> m_posted{};
+
+  std::mutex m_wakeup_lock;
+  std::function<void()> m_wakeup;
 };
 
 POLYBAR_NS_END
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "common.hpp"
 
 POLYBAR_NS
@@ -24,19 +26,56 @@ namespace signals {
     struct command;
     struct hook;
     struct action;
+    struct batch;
   } // namespace ipc
   namespace ui {
     struct changed;
     struct button_press;
     struct visibility_change;
+    struct module_output;
     struct dim_window;
     struct request_snapshot;
     struct update_background;
     struct update_geometry;
+    struct x_error;
+    struct x_generic_event;
   } // namespace ui
   namespace ui_tray {
     struct tray_pos_change;
   } // namespace ui_tray
+
+  namespace detail {
+    template <typename... Signals>
+    struct signal_list {
+      static constexpr size_t size = sizeof...(Signals);
+    };
+
+    template <typename Signal, typename List>
+    struct signal_slot;
+
+    template <typename Signal, typename... Rest>
+    struct signal_slot<Signal, signal_list<Signal, Rest...>> : std::integral_constant<size_t, 0> {};
+
+    template <typename Signal, typename First, typename... Rest>
+    struct signal_slot<Signal, signal_list<First, Rest...>>
+        : std::integral_constant<size_t, 1 + signal_slot<Signal, signal_list<Rest...>>::value> {};
+  } // namespace detail
+
+  /**
+   * All signals that can be emitted
+   *
+   * Every signal has a fixed slot in the signal_emitter, given by its position in this list. Emitting a signal that is
+   * not listed here does not compile.
+   */
+  using all = detail::signal_list<eventqueue::exit_reload, eventqueue::notify_change, eventqueue::notify_forcechange,
+      eventqueue::check_state, ipc::command, ipc::hook, ipc::action, ipc::batch, ui::changed, ui::button_press,
+      ui::visibility_change, ui::module_output, ui::dim_window, ui::request_snapshot, ui::update_background,
+      ui::update_geometry, ui::x_error, ui::x_generic_event, ui_tray::tray_pos_change>;
+
+  template <typename Signal>
+  constexpr size_t slot() {
+    return detail::signal_slot<Signal, all>::value;
+  }
 } // namespace signals
 
 POLYBAR_NS_END
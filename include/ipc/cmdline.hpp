@@ -0,0 +1,37 @@
+#pragma once
+
+#include <deque>
+
+#include "common.hpp"
+#include "errors.hpp"
+#include "ipc/msg.hpp"
+
+POLYBAR_NS
+
+namespace ipc {
+  DEFINE_ERROR(cmdline_error);
+
+  /**
+   * Splits a line read by polybar-msg into the arguments a POSIX shell would pass for it on the command line
+   *
+   * Arguments are separated by spaces and tabs. Single quotes preserve everything up to the next single quote, double
+   * quotes preserve everything up to the next double quote except for backslash escapes of '"', '\\', '$' and '`'.
+   * Outside of quotes, a backslash preserves the next character.
+   *
+   * @throws cmdline_error If a quote is not closed or the line ends with a backslash
+   */
+  std::deque<string> split_line(const string& line);
+
+  /**
+   * Creates the message for the command line arguments of an action, cmd, or hook message
+   *
+   * Actions can also be passed as separate module name, action name, and data arguments, hooks are translated into
+   * hook actions.
+   *
+   * @returns The message type and payload
+   * @throws cmdline_error If the arguments are invalid
+   */
+  std::pair<type_t, string> parse_message(std::deque<string> args);
+}  // namespace ipc
+
+POLYBAR_NS_END
@@ -58,6 +58,15 @@ namespace ipc {
     const logger& m_log;
   };
 
+  /**
+   * Extracts the action strings from the payload of a BATCH message
+   *
+   * Empty lines are skipped.
+   *
+   * @throws decoder::error If the payload contains anything other than action strings
+   */
+  vector<string> decode_batch(const string& payload);
+
 }  // namespace ipc
 
 POLYBAR_NS_END
@@ -11,6 +11,11 @@ POLYBAR_NS
 namespace ipc {
   vector<uint8_t> encode(const type_t type, const vector<uint8_t>& data = {});
   vector<uint8_t> encode(const type_t type, const string& data);
+
+  /**
+   * Creates the payload of a BATCH message from the given action strings
+   */
+  string encode_batch(const vector<string>& actions);
 }  // namespace ipc
 
 POLYBAR_NS_END
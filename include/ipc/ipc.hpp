@@ -4,6 +4,8 @@
 
 #include "common.hpp"
 #include "components/eventloop.hpp"
+#include "events/signal_fwd.hpp"
+#include "events/signal_receiver.hpp"
 #include "ipc/decoder.hpp"
 #include "settings.hpp"
 #include "utils/concurrency.hpp"
@@ -20,8 +22,12 @@ namespace ipc {
    * A unique messaging channel will be setup for each
    * running process which will allow messages and
    * events to be sent to the process externally.
+   *
+   * Clients that subscribed to events are notified about module output and bar visibility changes.
    */
-  class ipc : public non_copyable_mixin, public non_movable_mixin {
+  class ipc : public non_copyable_mixin,
+              public non_movable_mixin,
+              public signal_receiver<SIGN_PRIORITY_IPC, signals::ui::module_output, signals::ui::visibility_change> {
    public:
     using make_type = unique_ptr<ipc>;
     static make_type make(eventloop::loop& loop);
@@ -31,6 +37,9 @@ namespace ipc {
 
     static string get_socket_path(int pid);
 
+    bool on(const signals::ui::module_output& evt) override;
+    bool on(const signals::ui::visibility_change& evt) override;
+
    protected:
     bool trigger_ipc(v0::ipc_type type, const string& msg);
     void trigger_legacy_ipc(const string& msg);
@@ -51,10 +60,30 @@ namespace ipc {
       ~connection();
       eventloop::pipe_handle_t client_pipe;
       decoder dec;
+
+      /**
+       * Whether the connection stays open after a response was sent
+       */
+      bool persistent{false};
+
+      bool subscribed{false};
+
+      /**
+       * Events the client subscribed to, empty for all events
+       */
+      std::set<string> events;
     };
 
+    void on_message(connection& c, type_t type, const vector<uint8_t>& msg);
+    void send(connection& c, vector<uint8_t>&& data, bool close_after);
+    void publish(const string& event, const string& data);
     void remove_client(connection& conn);
 
+    /**
+     * Number of connections subscribed to events
+     */
+    size_t m_subscribers{0};
+
     /**
      * Custom transparent comparator so that we can lookup and erase connections from their reference.
      */
@@ -68,6 +68,10 @@ namespace ipc {
    *
    * The format is very simple. The header defines the type (cmd or action) and the payload is the message for that type
    * as a string.
+   *
+   * By default, polybar answers a single message and closes the connection. After a SESSION or SUBSCRIBE message, the
+   * connection stays open: every following message is answered in order and the client closes the connection once it
+   * is done.
    */
   namespace v0 {
     enum class ipc_type : type_t {
@@ -79,8 +83,37 @@ namespace ipc {
        * Message type for ipc module actions
        */
       ACTION = 2,
+      /**
+       * Keeps the connection open for further messages. The payload is ignored.
+       */
+      SESSION = 3,
+      /**
+       * Subscribes to bar events, also keeps the connection open.
+       *
+       * The payload is a space separated list of event names (see EVENT_*), an empty payload subscribes to all events.
+       */
+      SUBSCRIBE = 4,
+      /**
+       * Message type for multiple module actions that are applied together.
+       *
+       * The payload contains one action string per line. All actions are executed before the bar is redrawn.
+       */
+      BATCH = 5,
     };
-  }
+
+    /**
+     * Message type sent by polybar to subscribed clients.
+     *
+     * The payload is the event name followed by a space and the event data:
+     *
+     * * "output <module name> <module contents>" whenever the output of a module changes
+     * * "visibility <visible|hidden>" whenever the bar is shown or hidden
+     */
+    static constexpr type_t TYPE_EVENT = 1;
+
+    static constexpr auto EVENT_OUTPUT = "output";
+    static constexpr auto EVENT_VISIBILITY = "visibility";
+  }  // namespace v0
 }  // namespace ipc
 
 POLYBAR_NS_END
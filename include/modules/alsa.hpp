@@ -10,6 +10,7 @@ POLYBAR_NS
 namespace alsa {
   class mixer;
   class control;
+  class poller;
 }  // namespace alsa
 
 namespace modules {
@@ -23,7 +24,9 @@ namespace modules {
    public:
     explicit alsa_module(const bar_settings&, string, const config&);
 
+    void start() override;
     void teardown();
+    void idle();
     bool has_event();
     bool update();
     string get_format() const;
@@ -37,6 +40,8 @@ namespace modules {
     static constexpr auto EVENT_TOGGLE = "toggle";
 
    protected:
+    void release();
+
     void action_inc();
     void action_dec();
     void action_toggle();
@@ -65,6 +70,8 @@ namespace modules {
 
     map<mixer, mixer_t> m_mixer;
     map<control, control_t> m_ctrl;
+    unique_ptr<alsa::poller> m_poller;
+    bool m_pending_events{false};
     int m_headphoneid{0};
     bool m_mapped{false};
     bool m_unmute_on_scroll{false};
@@ -1,13 +1,14 @@
 #pragma once
 
+#include "adapters/power_supply.hpp"
 #include "common.hpp"
-#include "modules/meta/inotify_module.hpp"
+#include "modules/meta/base.hpp"
 #include "modules/meta/types.hpp"
 
 POLYBAR_NS
 
 namespace modules {
-  class battery_module : public inotify_module<battery_module> {
+  class battery_module : public module<battery_module> {
    public:
     enum class state {
       NONE = 0,
@@ -17,53 +18,38 @@ namespace modules {
       FULL,
     };
 
-    enum class value {
-      NONE = 0,
-      ADAPTER,
-      CAPACITY,
-      CAPACITY_MAX,
-      VOLTAGE,
-      RATE,
-    };
-
-    template <typename ReturnType>
-    struct value_reader {
-      using return_type = ReturnType;
-
-      explicit value_reader() = default;
-      explicit value_reader(function<ReturnType()>&& fn) : m_fn(forward<decltype(fn)>(fn)) {}
-
-      ReturnType read() const {
-        return m_fn();
-      }
-
-     private:
-      const function<ReturnType()> m_fn;
-    };
-
-    using state_reader = mutex_wrapper<value_reader<bool /* is_charging */>>;
-    using capacity_reader = mutex_wrapper<value_reader<int /* percentage */>>;
-    using rate_reader = mutex_wrapper<value_reader<unsigned long /* seconds */>>;
-    using consumption_reader = mutex_wrapper<value_reader<string /* watts */>>;
-
    public:
     explicit battery_module(const bar_settings&, string, const config&);
 
     void start() override;
     void teardown();
-    void idle();
-    bool on_event(const inotify_event& event);
     string get_format() const;
     bool build(builder* builder, const string& tag) const;
 
     static constexpr auto TYPE = BATTERY_TYPE;
 
    protected:
-    state current_state();
-    int current_percentage();
+    /**
+     * Snapshot of all raw values read from sysfs in a single sweep
+     */
+    struct values {
+      bool charging{false};
+      unsigned long capacity_now{0};
+      unsigned long capacity_full{0};
+      unsigned long rate{0};
+      unsigned long voltage{0};
+    };
+
+    values read_values() const;
+    state get_state(const values& v) const;
+    int get_percentage(const values& v) const;
     int clamp_percentage(int percentage, state state) const;
-    string current_time();
-    string current_consumption();
+    string get_time(const values& v) const;
+    string get_consumption(const values& v) const;
+
+    bool update(bool force = false);
+    chrono::milliseconds next_timeout() const;
+    void runner();
     void subthread();
 
    private:
@@ -83,12 +69,35 @@ namespace modules {
     static constexpr const char* TAG_LABEL_FULL{"<label-full>"};
     static constexpr const char* TAG_LABEL_LOW{"<label-low>"};
 
-    static const size_t SKIP_N_UNCHANGED{3_z};
-
-    unique_ptr<state_reader> m_state_reader;
-    unique_ptr<capacity_reader> m_capacity_reader;
-    unique_ptr<rate_reader> m_rate_reader;
-    unique_ptr<consumption_reader> m_consumption_reader;
+    /**
+     * Number of polls at FAST_INTERVAL after a uevent or a state change.
+     *
+     * Some drivers take a moment to settle on new values after the charging
+     * state flips.
+     */
+    static const size_t FAST_POLLS{3_z};
+    static constexpr chrono::milliseconds FAST_INTERVAL{1000};
+
+    unique_ptr<power_supply::uevent_monitor> m_uevents;
+
+    unique_ptr<power_supply::attribute> m_state_attr;
+    /**
+     * Prefix of the state attribute value that indicates charging
+     */
+    string m_charging_value;
+    unique_ptr<power_supply::attribute> m_capnow_attr;
+    unique_ptr<power_supply::attribute> m_capfull_attr;
+    unique_ptr<power_supply::attribute> m_rate_attr;
+    unique_ptr<power_supply::attribute> m_voltage_attr;
+    /**
+     * Whether m_rate_attr reports a current (as opposed to a power)
+     */
+    bool m_rate_is_current{false};
+
+    /**
+     * Whether any label uses a token that needs the rate and voltage values
+     */
+    bool m_needs_rate{false};
 
     label_t m_label_charging;
     label_t m_label_discharging;
@@ -101,21 +110,14 @@ namespace modules {
     ramp_t m_ramp_capacity;
     ramp_t m_ramp_charging;
 
-    string m_fstate;
-    string m_fcapnow;
-    string m_fcapfull;
-    string m_frate;
-    string m_fvoltage;
-
     state m_state{state::DISCHARGING};
     int m_percentage{0};
 
     int m_fullat{100};
     int m_lowat{10};
     string m_timeformat;
-    size_t m_unchanged{SKIP_N_UNCHANGED};
-    chrono::duration<double> m_interval{};
-    chrono::steady_clock::time_point m_lastpoll;
+    size_t m_fast_polls{0};
+    chrono::milliseconds m_interval{};
     thread m_subthread;
   };
 } // namespace modules
@@ -37,6 +37,7 @@ namespace modules {
     static constexpr auto TYPE = IPC_TYPE;
 
     static constexpr auto EVENT_SEND = "send";
+    static constexpr auto EVENT_SET = "set";
     static constexpr auto EVENT_HOOK = "hook";
     static constexpr auto EVENT_NEXT = "next";
     static constexpr auto EVENT_PREV = "prev";
@@ -44,6 +45,7 @@ namespace modules {
 
    protected:
     void action_send(const string& data);
+    void action_set(const string& data);
     void action_hook(const string& data);
     void action_next();
     void action_prev();
@@ -66,6 +68,11 @@ namespace modules {
     map<mousebtn, string> m_actions;
     string m_output;
 
+    /**
+     * Values of the named label tokens set through the set action
+     */
+    map<string, string> m_tokens;
+
     int m_initial{-1};
     int m_current_hook{-1};
     void exec_hook();
@@ -133,9 +133,27 @@ namespace modules {
     virtual void join() = 0;
     virtual void stop() = 0;
     virtual void halt(string error_message) = 0;
-    virtual string contents() = 0;
+
+    /**
+     * Formatted output of the module
+     *
+     * The returned buffer is never modified, a new buffer is published whenever the output changes.
+     */
+    virtual shared_ptr<const string> contents() = 0;
+
+    /**
+     * Identifies the buffer last returned by contents()
+     *
+     * Generations are unique across all modules, so comparing them is enough to tell whether an output changed.
+     */
+    virtual size_t generation() const = 0;
   };
 
+  /**
+   * Returns a generation that was not used by any module before
+   */
+  size_t next_generation();
+
   // }}}
   // class definition : module {{{
 
@@ -162,7 +180,8 @@ namespace modules {
     void stop() override;
     void halt(string error_message) override;
     void teardown();
-    string contents() override;
+    shared_ptr<const string> contents() override;
+    size_t generation() const override;
 
     bool input(const string& action, const string& data) final override;
 
@@ -221,7 +240,8 @@ namespace modules {
     atomic<bool> m_enabled{false};
     atomic<bool> m_visible{true};
     atomic<bool> m_changed{true};
-    string m_cache;
+    shared_ptr<const string> m_cache{std::make_shared<const string>()};
+    size_t m_generation{0};
   };
 
   // }}}
@@ -103,7 +103,7 @@ namespace modules {
       CAST_MOD(Impl)->wakeup();
       CAST_MOD(Impl)->teardown();
 
-      m_sig.emit(signals::eventqueue::check_state{});
+      m_sig.post<signals::eventqueue::check_state>();
     }
   }
 
@@ -118,21 +118,32 @@ namespace modules {
   void module<Impl>::teardown() {}
 
   template <typename Impl>
-  string module<Impl>::contents() {
+  shared_ptr<const string> module<Impl>::contents() {
     if (m_changed.exchange(false)) {
       m_log.info("%s: Rebuilding cache", name());
-      m_cache = CAST_MOD(Impl)->get_output();
+      string output = CAST_MOD(Impl)->get_output();
       // Make sure builder is really empty
       m_builder->flush();
-      if (!m_cache.empty()) {
+      if (!output.empty()) {
         // Add a reset tag after the module
         m_builder->control(tags::controltag::R);
-        m_cache += m_builder->flush();
+        output += m_builder->flush();
+      }
+
+      if (output != *m_cache) {
+        m_cache = std::make_shared<const string>(move(output));
+        m_generation = next_generation();
+        m_sig.emit(signals::ui::module_output{make_pair(name_raw(), *m_cache)});
       }
     }
     return m_cache;
   }
 
+  template <typename Impl>
+  size_t module<Impl>::generation() const {
+    return m_generation;
+  }
+
   template <typename Impl>
   bool module<Impl>::input(const string& name, const string& data) {
     if (!m_router->has_action(name)) {
@@ -153,7 +164,7 @@ namespace modules {
   template <typename Impl>
   void module<Impl>::broadcast() {
     m_changed = true;
-    m_sig.emit(signals::eventqueue::notify_change{});
+    m_sig.post<signals::eventqueue::notify_change>();
   }
 
   template <typename Impl>
@@ -20,6 +20,21 @@ namespace modules {
    * @param config A @ref config instance
    */
   module_t make_module(string&& type, const bar_settings& bar, string module_name, const logger& log, const config& config);
+
+  /**
+   * Returns true if modules of the given type have to be created on the main thread.
+   *
+   * This is the case for modules that use the X connection during construction or that initialize libraries which
+   * are not thread-safe.
+   */
+  bool needs_main_thread(const string& type);
+
+  /**
+   * Returns true if modules of the given type depend on the bar they are displayed on (e.g. on its monitor).
+   *
+   * Such modules are never shared between multiple bars in the same process.
+   */
+  bool is_bar_specific(const string& type);
 } // namespace modules
 
 POLYBAR_NS_END
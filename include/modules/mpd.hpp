@@ -50,6 +50,8 @@ namespace modules {
     void action_consume();
     void action_seek(const string& data);
 
+    chrono::milliseconds next_tick() const;
+
    private:
     static constexpr const char* FORMAT_ONLINE{"format-online"};
     static constexpr const char* FORMAT_PLAYING{"format-playing"};
@@ -93,6 +95,17 @@ namespace modules {
      */
     unique_ptr<mpdstatus> m_status;
 
+    /*
+     * Tags of the current song, only fetched again if the song id or the
+     * queue version changes
+     */
+    songinfo m_song;
+
+    /*
+     * Elapsed time (in seconds) shown in the last update
+     */
+    unsigned m_elapsed_shown{0U};
+
     string m_host{env_util::get("MPD_HOST", "127.0.0.1")};
     string m_pass;
     unsigned int m_port{6600U};
@@ -17,6 +17,7 @@ namespace modules {
     explicit pulseaudio_module(const bar_settings&, string, const config&);
 
     void teardown();
+    void idle();
     bool has_event();
     bool update();
     string get_format() const;
@@ -18,13 +18,26 @@ namespace modules {
     ~active_window();
 
     bool match(xcb_window_t win) const;
-    string title() const;
-    string instance_name() const;
-    string class_name() const;
+    bool invalidate(xcb_atom_t atom);
+    bool refresh();
+
+    const string& title() const;
+    const string& instance_name() const;
+    const string& class_name() const;
 
    private:
     xcb_connection_t* m_connection{nullptr};
     xcb_window_t m_window{XCB_NONE};
+
+    /**
+     * Cached window properties, only refetched after a PropertyNotify event for
+     * one of the underlying atoms.
+     */
+    bool m_title_valid{false};
+    bool m_class_valid{false};
+    string m_title;
+    string m_instance_name;
+    string m_class_name;
   };
 
   /**
@@ -44,7 +57,7 @@ namespace modules {
    protected:
     void handle(const evt::property_notify& evt) override;
 
-    void reset_active_window();
+    bool update_active_window();
 
    private:
     static constexpr const char* TAG_LABEL{"<label>"};
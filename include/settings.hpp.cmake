@@ -20,6 +20,8 @@ extern const char* const APP_VERSION;
 #cmakedefine01 WITH_XKB
 #cmakedefine01 WITH_XRM
 #cmakedefine01 WITH_XCURSOR
+#cmakedefine01 WITH_XSHM
+#cmakedefine01 WITH_XPRESENT
 
 #if WITH_XRANDR
 #cmakedefine01 WITH_XRANDR_MONITORS
@@ -44,6 +46,7 @@ extern const char* const APP_VERSION;
 #cmakedefine DEBUG_FONTCONFIG
 #endif
 
+static const int SIGN_PRIORITY_IPC{0};
 static const int SIGN_PRIORITY_CONTROLLER{1};
 static const int SIGN_PRIORITY_SCREEN{2};
 static const int SIGN_PRIORITY_BAR{3};
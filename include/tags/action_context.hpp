@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <initializer_list>
 #include <map>
 
 #include "common.hpp"
@@ -23,6 +25,19 @@ namespace tags {
 
   static constexpr action_t NO_ACTION = -1;
 
+  /**
+   * Set of mouse buttons, bit i is set if static_cast<mousebtn>(i) is in the set.
+   */
+  using btn_mask = unsigned int;
+
+  static inline btn_mask make_btn_mask(std::initializer_list<mousebtn> buttons) {
+    btn_mask mask{0};
+    for (auto btn : buttons) {
+      mask |= 1U << static_cast<unsigned int>(btn);
+    }
+    return mask;
+  }
+
   /**
    * Defines a clickable (or scrollable) action block.
    *
@@ -98,9 +113,22 @@ namespace tags {
 
     void set_alignment_start(const alignment a, const double x);
 
+    /**
+     * Builds the lookup index used by get_actions, has_action and has_any_action.
+     *
+     * Must be called once all action blocks are closed and all alignment starts are set. Any later modification
+     * invalidates the index and lookups fall back to a linear scan until it is rebuilt.
+     */
+    void build_index();
+
     std::map<mousebtn, tags::action_t> get_actions(int x) const;
     action_t has_action(mousebtn btn, int x) const;
 
+    /**
+     * Checks whether any of the given buttons has an action at the given position.
+     */
+    bool has_any_action(btn_mask buttons, int x) const;
+
     string get_action(action_t id) const;
     bool has_double_click() const;
 
@@ -113,6 +141,25 @@ namespace tags {
     void set_start(action_t id, double x);
     void set_end(action_t id, double x);
 
+    /**
+     * The topmost action for every button in a section of the bar.
+     */
+    struct action_span {
+      /**
+       * Absolute start position of the span (inclusive).
+       *
+       * The span ends where the next span starts.
+       */
+      int start;
+      /**
+       * Buttons that have an action in this span.
+       */
+      btn_mask mask;
+      std::array<action_t, static_cast<size_t>(mousebtn::BTN_COUNT)> ids;
+    };
+
+    const action_span* find_span(int x) const;
+
     /**
      * Stores all currently known action blocks.
      *
@@ -129,6 +176,18 @@ namespace tags {
      */
     std::map<alignment, double> m_align_start{
         {alignment::NONE, 0}, {alignment::LEFT, 0}, {alignment::CENTER, 0}, {alignment::RIGHT, 0}};
+
+    /**
+     * Non-overlapping spans sorted by their start position.
+     *
+     * Together they cover all action blocks, which allows lookups with a binary search.
+     */
+    std::vector<action_span> m_spans;
+
+    /**
+     * Whether m_spans reflects the current action blocks.
+     */
+    bool m_index_valid{false};
   };
 
 } // namespace tags
@@ -28,6 +28,7 @@ namespace tags {
 
     explicit dispatch(const logger& logger, action_context& action_ctxt);
     void parse(const bar_settings& bar, renderer_interface&, const string&& data);
+    void parse(const bar_settings& bar, renderer_interface&, shared_ptr<const string> data);
 
    protected:
     void handle_text(renderer_interface& renderer, string&& data);
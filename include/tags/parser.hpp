@@ -93,6 +93,11 @@ namespace tags {
      */
     void set(const string&& input);
 
+    /**
+     * Same as set(const string&&) but parses the shared string without copying it
+     */
+    void set(shared_ptr<const string> input);
+
     /**
      * Whether a call to next_element() suceeds.
      */
@@ -139,7 +144,7 @@ namespace tags {
     string get_tag_value();
 
    private:
-    string input;
+    shared_ptr<const string> input{std::make_shared<const string>()};
     size_t pos = 0;
 
     /**
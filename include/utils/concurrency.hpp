@@ -1,5 +1,7 @@
 #pragma once
 
+#include <condition_variable>
+#include <exception>
 #include <mutex>
 #include <thread>
 
@@ -36,6 +38,64 @@ class mutex_wrapper : public T {
 
 namespace concurrency_util {
   size_t thread_id(const thread::id id);
+
+  /**
+   * Calls fn(i) for every i in [0, count) on a small pool of threads
+   *
+   * The calling thread takes part in the work, at most max_threads threads are used in total. Returns once all calls
+   * have finished. If any of the calls throws, the first exception is rethrown afterwards.
+   */
+  void parallel_for(size_t count, const function<void(size_t)>& fn, size_t max_threads = 4);
+
+  /**
+   * Threads that are kept around to run parallel_for-like jobs
+   *
+   * Starting threads for every job is too expensive for work that is repeated often, like rendering a frame. The
+   * threads of the pool wait for the next job instead. Jobs must only be started from one thread at a time.
+   */
+  class worker_pool : public non_copyable_mixin, public non_movable_mixin {
+   public:
+    /**
+     * @param num_threads Number of threads working on a job, including the thread that starts it
+     */
+    explicit worker_pool(size_t num_threads);
+    ~worker_pool();
+
+    size_t size() const;
+
+    /**
+     * Calls fn(i) for every i in [0, count) on the threads of the pool
+     *
+     * Same as parallel_for, the calling thread takes part in the work and the first exception is rethrown once all
+     * calls have finished.
+     */
+    void run(size_t count, const function<void(size_t)>& fn);
+
+   protected:
+    void work();
+    void work_on_job(std::unique_lock<mutex>& guard);
+
+   private:
+    vector<thread> m_threads;
+
+    mutex m_mutex;
+    /**
+     * Signals the workers that a job was started or the pool is stopped
+     */
+    std::condition_variable m_started;
+    /**
+     * Signals run() that the last call of the job finished
+     */
+    std::condition_variable m_finished;
+
+    const function<void(size_t)>* m_job{nullptr};
+    size_t m_job_id{0};
+    size_t m_count{0};
+    size_t m_next{0};
+    size_t m_remaining{0};
+    std::exception_ptr m_error;
+    bool m_stopped{false};
+  };
 }
 
 POLYBAR_NS_END
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common.hpp"
+
+POLYBAR_NS
+
+/**
+ * Bounded lock-free queue for multiple producers and consumers
+ *
+ * Every cell carries a sequence number that tells producers and consumers whether the cell is free or filled for the
+ * current lap around the buffer, so neither side needs a lock. push() fails instead of blocking when the buffer is
+ * full.
+ *
+ * The capacity is rounded up to the next power of two.
+ */
+template <typename T>
+class ring_buffer {
+ public:
+  explicit ring_buffer(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+
+    m_mask = size - 1;
+    m_cells = std::make_unique<cell[]>(size);
+    for (size_t i = 0; i < size; i++) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ring_buffer(const ring_buffer&) = delete;
+  ring_buffer& operator=(const ring_buffer&) = delete;
+
+  /**
+   * Moves the value into the buffer
+   *
+   * @returns false if the buffer is full, the value is left untouched in that case
+   */
+  bool push(T&& value) {
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    cell* target;
+
+    while (true) {
+      target = &m_cells[pos & m_mask];
+      size_t seq = target->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+
+    target->value = std::move(value);
+    target->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Moves the oldest value out of the buffer
+   *
+   * @returns false if the buffer is empty
+   */
+  bool pop(T& value) {
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    cell* target;
+
+    while (true) {
+      target = &m_cells[pos & m_mask];
+      size_t seq = target->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    value = std::move(target->value);
+    target->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Approximate number of values in the buffer
+   *
+   * Only exact if no other thread modifies the buffer at the same time.
+   */
+  size_t size() const {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+  }
+
+  size_t capacity() const {
+    return m_mask + 1;
+  }
+
+ private:
+  struct cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<cell[]> m_cells;
+  size_t m_mask;
+
+  /*
+   * Producers and consumers work on different ends of the buffer, keep the two positions on separate cache lines.
+   */
+  alignas(64) std::atomic<size_t> m_head{0};
+  alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "settings.hpp"
+
+#if not WITH_XPRESENT
+#error "Not built with support for xcb-present..."
+#endif
+
+#include <xcb/present.h>
+#include <xcb/xcb.h>
+
+#include <chrono>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+class connection;
+class logger;
+
+/**
+ * Shows pixmaps in a window with the X Present extension
+ *
+ * The server copies a presented pixmap to the window at the next vertical blank of the monitor, so the window never
+ * shows a partially updated frame. Only one frame can be in flight at a time, the pixmap must not be drawn to until
+ * the frame was shown.
+ */
+class present_window : public non_copyable_mixin, public non_movable_mixin {
+ public:
+  /**
+   * A frame that has not been shown after this time is considered lost
+   */
+  static constexpr std::chrono::milliseconds FRAME_TIMEOUT{250};
+
+  /**
+   * @returns nullptr if the server does not support the Present extension
+   */
+  static unique_ptr<present_window> make(connection& conn, const logger& log, xcb_window_t window);
+
+  ~present_window();
+
+  /**
+   * Queues the pixmap to be copied to the window at the next vertical blank
+   */
+  void present(xcb_pixmap_t pixmap);
+
+  /**
+   * Whether the last presented frame was not shown yet
+   */
+  bool pending();
+
+  /**
+   * Handles the CompleteNotify event for the frame in flight
+   *
+   * @returns true if the event belongs to this window
+   */
+  bool handle(const xcb_generic_event_t* evt);
+
+ protected:
+  present_window(connection& conn, const logger& log, xcb_window_t window, uint8_t opcode, uint32_t eid);
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  connection& m_connection;
+  const logger& m_log;
+  xcb_window_t m_window;
+
+  /**
+   * Major opcode of the extension, identifies its generic events
+   */
+  uint8_t m_opcode;
+  uint32_t m_eid;
+
+  uint32_t m_serial{0};
+  bool m_pending{false};
+  clock::time_point m_submitted{};
+
+  size_t m_frames{0};
+  std::chrono::microseconds m_total_latency{0};
+};
+
+POLYBAR_NS_END
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "settings.hpp"
+
+#if not WITH_XSHM
+#error "Not built with support for xcb-shm..."
+#endif
+
+#include <xcb/shm.h>
+#include <xcb/xcb.h>
+
+#include <chrono>
+
+#include "common.hpp"
+#include "utils/mixins.hpp"
+
+POLYBAR_NS
+
+class connection;
+class logger;
+
+/**
+ * Image in a MIT-SHM segment that is shared with the X server
+ *
+ * The pixels are written directly into the segment and the server reads them from there when they are presented, so
+ * no pixel data is sent over the connection. Only works if the server runs on the same machine.
+ *
+ * The image uses the ZPixmap format with 32 bits per pixel, which is the memory layout of the cairo image formats
+ * ARGB32 and RGB24.
+ */
+class shm_image : public non_copyable_mixin, public non_movable_mixin {
+ public:
+  /**
+   * Creates an image of the given size for drawables of the given visual and depth
+   *
+   * @returns nullptr if the server does not support MIT-SHM, cannot attach the segment or uses a pixel layout that
+   *          does not match the cairo image formats.
+   */
+  static unique_ptr<shm_image> make(
+      connection& conn, const logger& log, const xcb_visualtype_t* visual, uint8_t depth, uint16_t w, uint16_t h);
+
+  ~shm_image();
+
+  unsigned char* data() const;
+  int stride() const;
+
+  /**
+   * Copies the given area of the image to the same position in the drawable
+   *
+   * The server reads from the segment asynchronously, the image must not be modified while pending() is true.
+   */
+  void put(xcb_drawable_t dst, xcb_gcontext_t gc, const xcb_rectangle_t& area);
+
+  /**
+   * Whether the server may still be reading the image for the last put()
+   */
+  bool pending();
+
+  /**
+   * Handles the completion event of the last put()
+   *
+   * @returns true if the event belongs to this image
+   */
+  bool handle(const xcb_generic_event_t* evt);
+
+  /**
+   * Blocks until the server has finished reading the image for the last put()
+   */
+  void wait();
+
+  /**
+   * A put() that did not complete after this time is considered finished
+   *
+   * The server does not send a completion event if the request failed.
+   */
+  static constexpr std::chrono::milliseconds PUT_TIMEOUT{250};
+
+ protected:
+  shm_image(connection& conn, xcb_shm_seg_t seg, unsigned char* data, uint8_t event_base, uint8_t depth, uint16_t w,
+      uint16_t h);
+
+ private:
+  connection& m_connection;
+  xcb_shm_seg_t m_seg;
+  unsigned char* m_data;
+
+  /**
+   * Response type of the first event of the extension, identifies completion events
+   */
+  uint8_t m_event_base;
+  uint8_t m_depth;
+  uint16_t m_width;
+  uint16_t m_height;
+  bool m_pending{false};
+  unsigned int m_sequence{0};
+  std::chrono::steady_clock::time_point m_submitted{};
+};
+
+POLYBAR_NS_END
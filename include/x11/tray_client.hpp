@@ -6,7 +6,6 @@
 #include "cairo/surface.hpp"
 #include "common.hpp"
 #include "utils/concurrency.hpp"
-#include "x11/background_manager.hpp"
 #include "x11/xembed.hpp"
 
 /*
@@ -24,8 +23,7 @@ namespace tray {
 
 class client : public non_copyable_mixin, public non_movable_mixin {
  public:
-  explicit client(
-      const logger& log, connection& conn, xcb_window_t parent, xcb_window_t win, size s, rgba desired_background);
+  explicit client(const logger& log, connection& conn, xcb_window_t parent, xcb_window_t win, size s);
   ~client();
 
   string name() const;
@@ -57,14 +55,12 @@ class client : public non_copyable_mixin, public non_movable_mixin {
   void add_to_save_set() const;
 
   void ensure_state() const;
-  void set_position(int x, int y);
+  bool set_position(int x, int y);
   void configure_notify() const;
 
-  void update_bg() const;
+  void update_bg(const cairo::surface& background, position origin) const;
 
  protected:
-  void observe_background();
-
   const logger& m_log;
 
   connection& m_connection;
@@ -124,10 +120,6 @@ class client : public non_copyable_mixin, public non_movable_mixin {
   size m_size;
   position m_pos{0, 0};
 
-  const rgba m_desired_background;
-  const bool m_transparent{m_desired_background.is_transparent()};
-  background_manager& m_background_manager;
-  shared_ptr<bg_slice> m_bg_slice{nullptr};
   unique_ptr<cairo::context> m_context;
   unique_ptr<cairo::xcb_surface> m_surface;
 };
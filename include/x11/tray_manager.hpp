@@ -85,7 +85,8 @@ class manager
     : public xpp::event::sink<evt::expose, evt::client_message, evt::configure_request, evt::resize_request,
           evt::selection_clear, evt::property_notify, evt::reparent_notify, evt::destroy_notify, evt::map_notify,
           evt::unmap_notify>,
-      public signal_receiver<SIGN_PRIORITY_TRAY, signals::ui::update_background, signals::ui_tray::tray_pos_change>,
+      public signal_receiver<SIGN_PRIORITY_TRAY, signals::ui::update_background, signals::ui::x_error,
+          signals::ui_tray::tray_pos_change>,
       non_copyable_mixin,
       non_movable_mixin {
  public:
@@ -115,6 +116,10 @@ class manager
   void reconfigure_clients();
   void redraw_clients();
 
+  bool update_background_area();
+  void paint_background();
+  void free_background();
+
   void query_atom();
   void set_tray_colors();
   void set_tray_orientation();
@@ -136,7 +141,6 @@ class manager
   client* find_client(const xcb_window_t& win);
   void remove_client(const client& client);
   void remove_client(xcb_window_t win);
-  void clean_clients();
 
   void handle(const evt::expose& evt) override;
   void handle(const evt::client_message& evt) override;
@@ -150,6 +154,7 @@ class manager
   void handle(const evt::unmap_notify& evt) override;
 
   bool on(const signals::ui::update_background& evt) override;
+  bool on(const signals::ui::x_error& evt) override;
   bool on(const signals::ui_tray::tray_pos_change& evt) override;
 
  private:
@@ -210,6 +215,27 @@ class manager
    * Whether the tray is visible
    */
   bool m_hidden{false};
+
+  /**
+   * Area covered by the background strip, relative to the bar window.
+   */
+  xcb_rectangle_t m_bg_rect{0, 0, 0U, 0U};
+
+  /**
+   * Background of the whole tray area.
+   *
+   * The desktop background (for pseudo-transparency) and the tray background are composited into this pixmap once and
+   * every client copies its part from here.
+   */
+  xcb_pixmap_t m_bg_pixmap{XCB_NONE};
+  unique_ptr<cairo::xcb_surface> m_bg_surface;
+  unique_ptr<cairo::context> m_bg_context;
+  shared_ptr<bg_slice> m_bg_slice{nullptr};
+
+  /**
+   * Whether the background strip has to be painted again before it is copied to the clients.
+   */
+  bool m_bg_dirty{true};
 };
 
 } // namespace tray
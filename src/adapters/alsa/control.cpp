@@ -78,15 +78,61 @@ namespace alsa {
       throw_exception<control_error>("Failed to wait for events", err);
     }
 
+    return read_events();
+  }
+
+  /**
+   * Read all pending events (the control is opened in non-blocking mode)
+   *
+   * @return true if any of them changed the value of an element
+   */
+  bool control::read_events() {
     snd_ctl_event_t* event{nullptr};
     snd_ctl_event_alloca(&event);
 
-    if ((err = snd_ctl_read(m_ctl, event)) == -1) {
-      return false;
+    bool changed{false};
+
+    while (snd_ctl_read(m_ctl, event) > 0) {
+      if (snd_ctl_event_get_type(event) == SND_CTL_EVENT_ELEM) {
+        changed = changed || (snd_ctl_event_elem_get_mask(event) & SND_CTL_EVENT_MASK_VALUE);
+      }
+    }
+
+    return changed;
+  }
+
+  /**
+   * Number of file descriptors to poll for this control
+   */
+  int control::poll_descriptors_count() {
+    return snd_ctl_poll_descriptors_count(m_ctl);
+  }
+
+  /**
+   * Fill the given array with the file descriptors to poll for this control
+   */
+  int control::poll_descriptors(struct pollfd* fds, unsigned int space) {
+    int err{0};
+    if ((err = snd_ctl_poll_descriptors(m_ctl, fds, space)) < 0) {
+      throw_exception<control_error>("Failed to get poll descriptors", err);
+    }
+    return err;
+  }
+
+  /**
+   * Read pending events after the descriptors returned by poll_descriptors were polled
+   *
+   * @return true if the value of an element changed
+   */
+  bool control::handle_revents(struct pollfd* fds, unsigned int nfds) {
+    unsigned short revents{0};
+    int err{0};
+    if ((err = snd_ctl_poll_descriptors_revents(m_ctl, fds, nfds, &revents)) < 0) {
+      throw_exception<control_error>("Failed to get poll events", err);
     }
 
-    if (snd_ctl_event_get_type(event) == SND_CTL_EVENT_ELEM) {
-      return snd_ctl_event_elem_get_mask(event) & SND_CTL_EVENT_MASK_VALUE;
+    if (revents & POLLIN) {
+      return read_events();
     }
 
     return false;
@@ -92,6 +92,43 @@ namespace alsa {
     return num_events;
   }
 
+  /**
+   * Number of file descriptors to poll for this mixer
+   */
+  int mixer::poll_descriptors_count() {
+    return snd_mixer_poll_descriptors_count(m_mixer);
+  }
+
+  /**
+   * Fill the given array with the file descriptors to poll for this mixer
+   */
+  int mixer::poll_descriptors(struct pollfd* fds, unsigned int space) {
+    int err{0};
+    if ((err = snd_mixer_poll_descriptors(m_mixer, fds, space)) < 0) {
+      throw_exception<mixer_error>("Failed to get poll descriptors", err);
+    }
+    return err;
+  }
+
+  /**
+   * Process pending events after the descriptors returned by poll_descriptors were polled
+   *
+   * @return true if the mixer had any events
+   */
+  bool mixer::handle_revents(struct pollfd* fds, unsigned int nfds) {
+    unsigned short revents{0};
+    int err{0};
+    if ((err = snd_mixer_poll_descriptors_revents(m_mixer, fds, nfds, &revents)) < 0) {
+      throw_exception<mixer_error>("Failed to get poll events", err);
+    }
+
+    if (revents & POLLIN) {
+      return process_events() > 0;
+    }
+
+    return false;
+  }
+
   /**
    * Get volume in percentage
    */
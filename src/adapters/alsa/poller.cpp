@@ -0,0 +1,105 @@
+#include "adapters/alsa/poller.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "adapters/alsa/control.hpp"
+#include "adapters/alsa/generic.hpp"
+#include "adapters/alsa/mixer.hpp"
+
+POLYBAR_NS
+
+namespace alsa {
+  /**
+   * Construct poller object
+   */
+  poller::poller() {
+    if ((m_interrupt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+      throw alsa_exception("Failed to create eventfd: "s + std::strerror(errno));
+    }
+  }
+
+  /**
+   * Deconstruct poller
+   */
+  poller::~poller() {
+    close(m_interrupt);
+  }
+
+  void poller::add(shared_ptr<mixer> m) {
+    m_sources.push_back(source{move(m), nullptr, 0, 0});
+  }
+
+  void poller::add(shared_ptr<control> c) {
+    m_sources.push_back(source{nullptr, move(c), 0, 0});
+  }
+
+  /**
+   * Gather the poll descriptors of all handles
+   *
+   * The interrupt eventfd always comes first. The descriptors have to be
+   * queried again before every poll since the revents are written into them.
+   */
+  void poller::build() {
+    m_fds.resize(1);
+    m_fds[0].fd = m_interrupt;
+    m_fds[0].events = POLLIN;
+    m_fds[0].revents = 0;
+
+    for (auto&& src : m_sources) {
+      int count = src.m ? src.m->poll_descriptors_count() : src.c->poll_descriptors_count();
+      src.offset = m_fds.size();
+      src.count = count > 0 ? count : 0;
+      m_fds.resize(src.offset + src.count);
+
+      if (src.count > 0) {
+        src.count = src.m ? src.m->poll_descriptors(&m_fds[src.offset], src.count)
+                          : src.c->poll_descriptors(&m_fds[src.offset], src.count);
+        m_fds.resize(src.offset + src.count);
+      }
+    }
+  }
+
+  bool poller::wait(int timeout) {
+    build();
+
+    if (::poll(m_fds.data(), m_fds.size(), timeout) <= 0) {
+      return false;
+    }
+
+    if (m_fds[0].revents & POLLIN) {
+      eventfd_t value;
+      eventfd_read(m_interrupt, &value);
+    }
+
+    bool changed{false};
+
+    for (auto&& src : m_sources) {
+      bool fired{false};
+      for (size_t i = src.offset; i < src.offset + src.count && !fired; i++) {
+        fired = m_fds[i].revents != 0;
+      }
+
+      if (!fired) {
+        continue;
+      }
+
+      if (src.m) {
+        changed = src.m->handle_revents(&m_fds[src.offset], src.count) || changed;
+      } else {
+        changed = src.c->handle_revents(&m_fds[src.offset], src.count) || changed;
+      }
+    }
+
+    return changed;
+  }
+
+  void poller::interrupt() {
+    eventfd_write(m_interrupt, 1);
+  }
+} // namespace alsa
+
+POLYBAR_NS_END
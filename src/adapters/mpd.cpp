@@ -1,3 +1,8 @@
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cassert>
 #include <csignal>
 #include <thread>
@@ -79,6 +84,11 @@ namespace mpd {
     return m_song != nullptr;
   }
 
+  int mpdsong::get_id() {
+    assert(m_song);
+    return mpd_song_get_id(m_song.get());
+  }
+
   string mpdsong::get_artist() {
     assert(m_song);
     auto tag = mpd_song_get_tag(m_song.get(), MPD_TAG_ARTIST, 0);
@@ -133,11 +143,15 @@ namespace mpd {
     if (sigaction(SIGPIPE, &m_signal_action, nullptr) == -1) {
       throw mpd_exception("Could not setup signal handler: "s + std::strerror(errno));
     }
+    if ((m_interrupt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+      throw mpd_exception("Could not create eventfd: "s + std::strerror(errno));
+    }
   }
 
   mpdconnection::~mpdconnection() {
     m_signal_action.sa_handler = SIG_DFL;
     sigaction(SIGPIPE, &m_signal_action, nullptr);
+    close(m_interrupt);
   }
 
   void mpdconnection::connect() {
@@ -213,6 +227,55 @@ namespace mpd {
     return flags;
   }
 
+  bool mpdconnection::wait(chrono::milliseconds timeout) {
+    check_connection(m_connection.get());
+    assert(m_idle);
+
+    struct pollfd fds[2];
+    fds[0].fd = m_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_interrupt;
+    fds[1].events = POLLIN;
+
+    int ms = timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+
+    if (::poll(fds, 2, ms) <= 0) {
+      return false;
+    }
+
+    if (fds[1].revents & POLLIN) {
+      eventfd_t value;
+      eventfd_read(m_interrupt, &value);
+    }
+
+    return fds[0].revents & (POLLIN | POLLHUP | POLLERR);
+  }
+
+  void mpdconnection::interrupt() {
+    eventfd_write(m_interrupt, 1);
+  }
+
+  int mpdconnection::recv_idle() {
+    check_connection(m_connection.get());
+    if (!m_idle) {
+      return 0;
+    }
+
+    struct pollfd fds[1];
+    fds[0].fd = m_fd;
+    fds[0].events = POLLIN;
+
+    if (::poll(fds, 1, 0) <= 0) {
+      return 0;
+    }
+
+    m_idle = false;
+    int flags = mpd_recv_idle(m_connection.get(), false);
+    mpd_response_finish(m_connection.get());
+    check_errors(m_connection.get());
+    return flags;
+  }
+
   unique_ptr<mpdstatus> mpdconnection::get_status() {
     check_prerequisites();
     auto status = make_unique<mpdstatus>(this);
@@ -384,12 +447,14 @@ namespace mpd {
     m_status.reset(mpd_run_status(*conn));
     m_songid = mpd_status_get_song_id(m_status.get());
     m_queuelen = mpd_status_get_queue_length(m_status.get());
+    m_queue_version = mpd_status_get_queue_version(m_status.get());
     m_random = mpd_status_get_random(m_status.get());
     m_repeat = mpd_status_get_repeat(m_status.get());
     m_single = mpd_status_get_single(m_status.get());
     m_consume = mpd_status_get_consume(m_status.get());
-    m_elapsed_time = mpd_status_get_elapsed_time(m_status.get());
+    m_elapsed_time_ms = mpd_status_get_elapsed_ms(m_status.get());
     m_total_time = mpd_status_get_total_time(m_status.get());
+    m_fetched_at = chrono::steady_clock::now();
   }
 
   void mpdstatus::update(int event, mpdconnection* connection) {
@@ -403,8 +468,6 @@ namespace mpd {
 
     fetch_data(connection);
 
-    m_elapsed_time_ms = m_elapsed_time * 1000;
-
     auto state = mpd_status_get_state(m_status.get());
 
     switch (state) {
@@ -450,28 +513,54 @@ namespace mpd {
     return m_queuelen;
   }
 
+  unsigned mpdstatus::get_queue_version() const {
+    return m_queue_version;
+  }
+
   unsigned mpdstatus::get_total_time() const {
     return m_total_time;
   }
 
   unsigned mpdstatus::get_elapsed_time() const {
-    return m_elapsed_time;
+    return get_elapsed_time_ms() / 1000;
+  }
+
+  /**
+   * Get the current position in the song
+   *
+   * While playing, the time that passed since the status was fetched is added
+   * to the position reported by the server.
+   */
+  unsigned long mpdstatus::get_elapsed_time_ms() const {
+    unsigned long elapsed = m_elapsed_time_ms;
+
+    if (m_state == mpdstate::PLAYING) {
+      auto diff = chrono::steady_clock::now() - m_fetched_at;
+      elapsed += chrono::duration_cast<chrono::milliseconds>(diff).count();
+
+      if (m_total_time > 0) {
+        elapsed = std::min(elapsed, m_total_time * 1000);
+      }
+    }
+
+    return elapsed;
   }
 
-  unsigned mpdstatus::get_elapsed_percentage() {
+  unsigned mpdstatus::get_elapsed_percentage() const {
     if (m_total_time == 0) {
       return 0;
     }
-    return static_cast<int>(float(m_elapsed_time) / float(m_total_time) * 100.0 + 0.5f);
+    return static_cast<int>(float(get_elapsed_time()) / float(m_total_time) * 100.0 + 0.5f);
   }
 
-  string mpdstatus::get_formatted_elapsed() {
+  string mpdstatus::get_formatted_elapsed() const {
+    unsigned long elapsed = get_elapsed_time();
     char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%lu:%02lu", m_elapsed_time / 60, m_elapsed_time % 60);
+    snprintf(buffer, sizeof(buffer), "%lu:%02lu", elapsed / 60, elapsed % 60);
     return {buffer};
   }
 
-  string mpdstatus::get_formatted_total() {
+  string mpdstatus::get_formatted_total() const {
     char buffer[32];
     snprintf(buffer, sizeof(buffer), "%lu:%02lu", m_total_time / 60, m_total_time % 60);
     return {buffer};
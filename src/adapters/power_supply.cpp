@@ -0,0 +1,130 @@
+#include "adapters/power_supply.hpp"
+
+#include <fcntl.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "utils/string.hpp"
+
+POLYBAR_NS
+
+namespace power_supply {
+  // class : attribute {{{
+
+  attribute::attribute(string path) : m_path(move(path)), m_fd(m_path, O_RDONLY | O_CLOEXEC) {}
+
+  const string& attribute::path() const {
+    return m_path;
+  }
+
+  string attribute::read() const {
+    char buffer[128];
+    ssize_t bytes = pread(m_fd, buffer, sizeof(buffer), 0);
+
+    if (bytes < 0) {
+      throw system_error("Failed to read " + m_path);
+    }
+
+    return string_util::rtrim(string(buffer, bytes), '\n');
+  }
+
+  unsigned long attribute::read_ulong() const {
+    return std::strtoul(read().c_str(), nullptr, 10);
+  }
+
+  long attribute::read_long() const {
+    return std::strtol(read().c_str(), nullptr, 10);
+  }
+
+  // }}}
+  // class : uevent_monitor {{{
+
+  uevent_monitor::uevent_monitor() {
+    m_socket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+
+    if (m_socket == -1) {
+      throw system_error("Failed to open uevent socket");
+    }
+
+    struct sockaddr_nl addr {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_pid = 0;
+    // Multicast group 1 carries the uevents sent by the kernel
+    addr.nl_groups = 1;
+
+    if (bind(m_socket, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+      close(m_socket);
+      throw system_error("Failed to bind uevent socket");
+    }
+
+    if ((m_interrupt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+      close(m_socket);
+      throw system_error("Failed to create eventfd");
+    }
+  }
+
+  uevent_monitor::~uevent_monitor() {
+    close(m_socket);
+    close(m_interrupt);
+  }
+
+  bool uevent_monitor::wait(std::chrono::milliseconds timeout) {
+    struct pollfd fds[2];
+    fds[0].fd = m_socket;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_interrupt;
+    fds[1].events = POLLIN;
+
+    int ms = timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+
+    if (::poll(fds, 2, ms) <= 0) {
+      return false;
+    }
+
+    if (fds[1].revents & POLLIN) {
+      eventfd_t value;
+      eventfd_read(m_interrupt, &value);
+    }
+
+    return (fds[0].revents & POLLIN) && read_events();
+  }
+
+  void uevent_monitor::interrupt() {
+    eventfd_write(m_interrupt, 1);
+  }
+
+  /**
+   * Consume all pending uevents
+   *
+   * A uevent is a sequence of null-terminated strings, starting with
+   * ACTION@DEVPATH followed by KEY=VALUE pairs.
+   *
+   * @return true if any of them belongs to the power_supply subsystem
+   */
+  bool uevent_monitor::read_events() {
+    static constexpr const char SUBSYSTEM[] = "SUBSYSTEM=power_supply";
+    bool found = false;
+    char buffer[4096];
+    ssize_t bytes;
+
+    while ((bytes = recv(m_socket, buffer, sizeof(buffer) - 1, 0)) > 0) {
+      buffer[bytes] = '\0';
+
+      for (ssize_t pos = 0; pos < bytes && !found; pos += std::strlen(buffer + pos) + 1) {
+        found = std::strcmp(buffer + pos, SUBSYSTEM) == 0;
+      }
+    }
+
+    return found;
+  }
+
+  // }}}
+} // namespace power_supply
+
+POLYBAR_NS_END
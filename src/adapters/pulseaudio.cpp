@@ -1,5 +1,13 @@
 #include "adapters/pulseaudio.hpp"
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <bitset>
+#include <cerrno>
+#include <cstring>
+
 #include "components/logger.hpp"
 
 POLYBAR_NS
@@ -9,8 +17,14 @@ POLYBAR_NS
  */
 pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume)
     : m_log(logger), spec_s_name(sink_name) {
+  m_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_eventfd == -1) {
+    throw pulseaudio_error("Could not create eventfd: "s + std::strerror(errno));
+  }
+
   m_mainloop = pa_threaded_mainloop_new();
   if (!m_mainloop) {
+    close(m_eventfd);
     throw pulseaudio_error("Could not create pulseaudio threaded mainloop.");
   }
   pa_threaded_mainloop_lock(m_mainloop);
@@ -19,6 +33,7 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
   if (!m_context) {
     pa_threaded_mainloop_unlock(m_mainloop);
     pa_threaded_mainloop_free(m_mainloop);
+    close(m_eventfd);
     throw pulseaudio_error("Could not create pulseaudio context.");
   }
 
@@ -31,6 +46,7 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
     pa_context_unref(m_context);
     pa_threaded_mainloop_unlock(m_mainloop);
     pa_threaded_mainloop_free(m_mainloop);
+    close(m_eventfd);
     throw pulseaudio_error("Could not connect pulseaudio context.");
   }
 
@@ -39,6 +55,7 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
     pa_context_unref(m_context);
     pa_threaded_mainloop_unlock(m_mainloop);
     pa_threaded_mainloop_free(m_mainloop);
+    close(m_eventfd);
     throw pulseaudio_error("Could not start pulseaudio mainloop.");
   }
 
@@ -61,6 +78,7 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
     pa_context_disconnect(m_context);
     pa_context_unref(m_context);
     pa_threaded_mainloop_free(m_mainloop);
+    close(m_eventfd);
     throw pulseaudio_error("Could not connect to pulseaudio server.");
   }
 
@@ -88,6 +106,9 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
   }
   pa_context_set_subscribe_callback(m_context, subscribe_callback, this);
 
+  auto api = pa_threaded_mainloop_get_api(m_mainloop);
+  m_volume_event = api->time_new(api, nullptr, volume_timer_callback, this);
+
   update_volume(op);
 
   pa_threaded_mainloop_unlock(m_mainloop);
@@ -97,10 +118,29 @@ pulseaudio::pulseaudio(const logger& logger, string&& sink_name, bool max_volume
  * Deconstruct pulseaudio
  */
 pulseaudio::~pulseaudio() {
+  // Don't lose a volume change that is still waiting for the timer
+  pa_threaded_mainloop_lock(m_mainloop);
+  if (m_volume_dirty) {
+    m_volume_dirty = false;
+    pa_operation* op = pa_context_set_sink_volume_by_index(m_context, m_index, &cv, operation_callback, this);
+    if (op != nullptr) {
+      m_pending_ops++;
+      wait_loop(op, m_mainloop);
+    }
+  }
+
+  if (m_volume_event != nullptr) {
+    auto api = pa_threaded_mainloop_get_api(m_mainloop);
+    api->time_free(m_volume_event);
+    m_volume_event = nullptr;
+  }
+  pa_threaded_mainloop_unlock(m_mainloop);
+
   pa_threaded_mainloop_stop(m_mainloop);
   pa_context_disconnect(m_context);
   pa_context_unref(m_context);
   pa_threaded_mainloop_free(m_mainloop);
+  close(m_eventfd);
 }
 
 /**
@@ -113,51 +153,77 @@ const string& pulseaudio::get_name() {
 /**
  * Wait for events
  */
-bool pulseaudio::wait() {
-  return m_events.size() > 0;
+bool pulseaudio::wait(std::chrono::milliseconds timeout) {
+  if (has_events()) {
+    return true;
+  }
+
+  struct pollfd fds[1];
+  fds[0].fd = m_eventfd;
+  fds[0].events = POLLIN;
+
+  int ms = timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+
+  if (::poll(fds, 1, ms) > 0) {
+    eventfd_t value;
+    eventfd_read(m_eventfd, &value);
+  }
+
+  return has_events();
+}
+
+void pulseaudio::interrupt() {
+  eventfd_write(m_eventfd, 1);
+}
+
+bool pulseaudio::has_events() const {
+  return m_events.load() != 0U;
 }
 
 /**
  * Process queued pulseaudio events
  */
 int pulseaudio::process_events() {
-  int ret = m_events.size();
+  const unsigned int events = m_events.exchange(0U);
+  if (events == 0U) {
+    return 0;
+  }
+
+  const auto has = [events](evtype type) { return (events & (1U << static_cast<unsigned int>(type))) != 0U; };
+
   pa_threaded_mainloop_lock(m_mainloop);
   pa_operation* o{nullptr};
-  // clear the queue
-  while (!m_events.empty()) {
-    switch (m_events.front()) {
-      // try to get specified sink
-      case evtype::NEW:
-        // redundant if already using specified sink
-        if (!spec_s_name.empty()) {
-          o = pa_context_get_sink_info_by_name(m_context, spec_s_name.c_str(), sink_info_callback, this);
-          wait_loop(o, m_mainloop);
-          break;
-        }
-        // FALLTHRU
-      case evtype::SERVER:
-        // don't fallthrough only if always using default sink
-        if (!spec_s_name.empty()) {
-          break;
-        }
-        // FALLTHRU
-      // get default sink
-      case evtype::REMOVE:
-        o = pa_context_get_sink_info_by_name(m_context, DEFAULT_SINK, sink_info_callback, this);
-        wait_loop(o, m_mainloop);
-        if (spec_s_name != s_name) {
-          m_log.notice("pulseaudio: using default sink %s", s_name);
-        }
-        break;
-      default:
-        break;
+
+  /*
+   * The order of the events is lost, so the default sink is looked up first and the specified sink last. Looking up
+   * a sink that does not exist (anymore) leaves the current sink untouched, so a specified sink that was removed and
+   * added again is used again, same as when the events are processed one after another.
+   */
+  bool use_default_sink = has(evtype::REMOVE);
+
+  // the default sink only matters if we are always using it
+  if (spec_s_name.empty() && (has(evtype::NEW) || has(evtype::SERVER))) {
+    use_default_sink = true;
+  }
+
+  // get default sink
+  if (use_default_sink) {
+    o = pa_context_get_sink_info_by_name(m_context, DEFAULT_SINK, sink_info_callback, this);
+    wait_loop(o, m_mainloop);
+    if (spec_s_name != s_name) {
+      m_log.notice("pulseaudio: using default sink %s", s_name);
     }
-    update_volume(o);
-    m_events.pop();
   }
+
+  // try to get specified sink
+  if (has(evtype::NEW) && !spec_s_name.empty()) {
+    o = pa_context_get_sink_info_by_name(m_context, spec_s_name.c_str(), sink_info_callback, this);
+    wait_loop(o, m_mainloop);
+  }
+
+  update_volume(o);
   pa_threaded_mainloop_unlock(m_mainloop);
-  return ret;
+  return static_cast<int>(std::bitset<32>(events).count());
 }
 
 /**
@@ -177,20 +243,22 @@ double pulseaudio::get_decibels() {
 
 /**
  * Set volume to given percentage
+ *
+ * The change is applied locally right away and sent to the server asynchronously
  */
 void pulseaudio::set_volume(float percentage) {
   pa_threaded_mainloop_lock(m_mainloop);
   pa_volume_t vol = math_util::percentage_to_value<pa_volume_t>(percentage, PA_VOLUME_MUTED, PA_VOLUME_NORM);
   pa_cvolume_scale(&cv, vol);
-  pa_operation* op = pa_context_set_sink_volume_by_index(m_context, m_index, &cv, simple_callback, this);
-  wait_loop(op, m_mainloop);
-  if (!success)
-    throw pulseaudio_error("Failed to set sink volume.");
+  schedule_volume();
   pa_threaded_mainloop_unlock(m_mainloop);
 }
 
 /**
  * Increment or decrement volume by given percentage (prevents accumulation of rounding errors from get_volume)
+ *
+ * The change is applied locally right away, increments that follow each other
+ * quickly (e.g. when scrolling) are sent to the server as a single request.
  */
 void pulseaudio::inc_volume(int delta_perc) {
   pa_threaded_mainloop_lock(m_mainloop);
@@ -218,22 +286,28 @@ void pulseaudio::inc_volume(int delta_perc) {
     }
   }
 
-  pa_operation* op = pa_context_set_sink_volume_by_index(m_context, m_index, &cv, simple_callback, this);
-  wait_loop(op, m_mainloop);
-  if (!success)
-    throw pulseaudio_error("Failed to set sink volume.");
+  schedule_volume();
   pa_threaded_mainloop_unlock(m_mainloop);
 }
 
 /**
  * Set mute state
+ *
+ * The change is applied locally right away and sent to the server asynchronously
  */
 void pulseaudio::set_mute(bool mode) {
   pa_threaded_mainloop_lock(m_mainloop);
-  pa_operation* op = pa_context_set_sink_mute_by_index(m_context, m_index, mode, simple_callback, this);
-  wait_loop(op, m_mainloop);
-  if (!success)
-    throw pulseaudio_error("Failed to mute sink.");
+  if (muted != mode) {
+    muted = mode;
+    pa_operation* op = pa_context_set_sink_mute_by_index(m_context, m_index, mode, operation_callback, this);
+    if (op != nullptr) {
+      m_pending_ops++;
+      pa_operation_unref(op);
+    } else {
+      m_log.err("pulseaudio: Failed to mute sink (%s)", pa_strerror(pa_context_errno(m_context)));
+    }
+    push_event(evtype::CHANGE);
+  }
   pa_threaded_mainloop_unlock(m_mainloop);
 }
 
@@ -264,7 +338,8 @@ void pulseaudio::update_volume(pa_operation* o) {
  */
 void pulseaudio::get_sink_volume_callback(pa_context*, const pa_sink_info* info, int, void* userdata) {
   pulseaudio* This = static_cast<pulseaudio*>(userdata);
-  if (info) {
+  // Local changes that are still in flight take precedence over the server state
+  if (info && !This->has_pending_changes()) {
     This->cv = info->volume;
     This->muted = info->mute;
   }
@@ -280,22 +355,22 @@ void pulseaudio::subscribe_callback(pa_context*, pa_subscription_event_type_t t,
     case PA_SUBSCRIPTION_EVENT_SERVER:
       switch (t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) {
         case PA_SUBSCRIPTION_EVENT_CHANGE:
-          This->m_events.emplace(evtype::SERVER);
+          This->push_event(evtype::SERVER);
           break;
       }
       break;
     case PA_SUBSCRIPTION_EVENT_SINK:
       switch (t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) {
         case PA_SUBSCRIPTION_EVENT_NEW:
-          This->m_events.emplace(evtype::NEW);
+          This->push_event(evtype::NEW);
           break;
         case PA_SUBSCRIPTION_EVENT_CHANGE:
           if (idx == This->m_index)
-            This->m_events.emplace(evtype::CHANGE);
+            This->push_event(evtype::CHANGE);
           break;
         case PA_SUBSCRIPTION_EVENT_REMOVE:
           if (idx == This->m_index)
-            This->m_events.emplace(evtype::REMOVE);
+            This->push_event(evtype::REMOVE);
           break;
       }
       break;
@@ -312,6 +387,83 @@ void pulseaudio::simple_callback(pa_context*, int success, void* userdata) {
   pa_threaded_mainloop_signal(This->m_mainloop, 0);
 }
 
+/**
+ * Callback for volume and mute requests, nobody waits for those
+ */
+void pulseaudio::operation_callback(pa_context* context, int success, void* userdata) {
+  pulseaudio* This = static_cast<pulseaudio*>(userdata);
+  This->m_pending_ops--;
+
+  if (!success) {
+    This->m_log.err("pulseaudio: Failed to change sink volume (%s)", pa_strerror(pa_context_errno(context)));
+  }
+
+  // Once all requests are through, re-read the sink in case the server did not apply them as requested
+  if (!This->has_pending_changes()) {
+    This->push_event(evtype::CHANGE);
+  }
+  pa_threaded_mainloop_signal(This->m_mainloop, 0);
+}
+
+/**
+ * Fires VOLUME_DELAY after the first of a series of volume changes
+ */
+void pulseaudio::volume_timer_callback(pa_mainloop_api*, pa_time_event*, const struct timeval*, void* userdata) {
+  pulseaudio* This = static_cast<pulseaudio*>(userdata);
+  This->m_volume_scheduled = false;
+  This->send_volume();
+}
+
+/**
+ * Queue an event for the consumer and wake it up
+ */
+void pulseaudio::push_event(evtype type) {
+  m_events.fetch_or(1U << static_cast<unsigned int>(type));
+  eventfd_write(m_eventfd, 1);
+}
+
+/**
+ * Make sure the local volume is sent to the server after VOLUME_DELAY
+ *
+ * Has to be called with the mainloop locked
+ */
+void pulseaudio::schedule_volume() {
+  m_volume_dirty = true;
+  push_event(evtype::CHANGE);
+
+  if (!m_volume_scheduled) {
+    struct timeval tv {};
+    pa_timeval_add(pa_gettimeofday(&tv), VOLUME_DELAY);
+    auto api = pa_threaded_mainloop_get_api(m_mainloop);
+    api->time_restart(m_volume_event, &tv);
+    m_volume_scheduled = true;
+  }
+}
+
+/**
+ * Send the local volume as one absolute request without waiting for the reply
+ *
+ * Has to be called with the mainloop locked
+ */
+void pulseaudio::send_volume() {
+  if (!m_volume_dirty) {
+    return;
+  }
+
+  m_volume_dirty = false;
+  pa_operation* op = pa_context_set_sink_volume_by_index(m_context, m_index, &cv, operation_callback, this);
+  if (op != nullptr) {
+    m_pending_ops++;
+    pa_operation_unref(op);
+  } else {
+    m_log.err("pulseaudio: Failed to set sink volume (%s)", pa_strerror(pa_context_errno(m_context)));
+  }
+}
+
+bool pulseaudio::has_pending_changes() const {
+  return m_volume_dirty || m_pending_ops > 0;
+}
+
 /**
  * Callback when getting sink info & existence
  */
@@ -357,9 +357,6 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
 
   m_log.trace("bar: Attach X event sink");
   m_connection.attach_sink(this, SINK_PRIORITY_BAR);
-
-  m_log.trace("bar: Attach signal receiver");
-  m_sig.attach(this);
 }
 
 /**
@@ -367,7 +364,6 @@ bar::bar(connection& conn, signal_emitter& emitter, const config& config, const
  */
 bar::~bar() {
   m_connection.detach_sink(this, SINK_PRIORITY_BAR);
-  m_sig.detach(this);
 }
 
 /**
@@ -381,9 +377,10 @@ const bar_settings& bar::settings() const {
  * Parse input string and redraw the bar window
  *
  * @param data Input string
- * @param force Unless true, do not parse unchanged data
+ * @param force Unless true, do not parse the data that was parsed last
  */
-void bar::parse(string&& data, bool force) {
+void bar::parse(shared_ptr<const string> data, bool force) {
+  // The controller only passes new data if a module changed, comparing the buffers is enough
   bool unchanged = data == m_lastinput;
 
   m_lastinput = data;
@@ -396,6 +393,13 @@ void bar::parse(string&& data, bool force) {
     return m_log.trace("bar: Ignoring update (unchanged)");
   }
 
+  if (m_renderer->busy()) {
+    defer_frame();
+    return m_log.trace("bar: Deferring update until the current frame was shown");
+  }
+  m_frame_deferred = false;
+  m_frame_timer->stop();
+
   auto rect = m_opts.inner_area();
 
   if (m_tray && !m_tray->settings().detached && m_tray->settings().configured_slots) {
@@ -440,7 +444,7 @@ void bar::hide() {
     m_log.info("Hiding bar window");
     m_visible = false;
     reconfigure_struts();
-    m_sig.emit(visibility_change{false});
+    m_sig.emit(visibility_change{{m_opts.x_data.window, false}});
     m_connection.unmap_window_checked(m_opts.x_data.window);
     m_connection.flush();
   } catch (const exception& err) {
@@ -459,10 +463,10 @@ void bar::show() {
 
   try {
     m_log.info("Showing bar window");
-    m_sig.emit(visibility_change{true});
+    m_sig.emit(visibility_change{{m_opts.x_data.window, true}});
     map_window();
     m_connection.flush();
-    parse(string{m_lastinput}, true);
+    parse(m_lastinput, true);
   } catch (const exception& err) {
     m_log.err("Failed to map bar window (err=%s", err.what());
   }
@@ -639,11 +643,11 @@ void bar::broadcast_visibility() {
   auto attr = m_connection.get_window_attributes(m_opts.x_data.window);
 
   if (attr->map_state == XCB_MAP_STATE_UNVIEWABLE) {
-    m_sig.emit(visibility_change{false});
+    m_sig.emit(visibility_change{{m_opts.x_data.window, false}});
   } else if (attr->map_state == XCB_MAP_STATE_UNMAPPED) {
-    m_sig.emit(visibility_change{false});
+    m_sig.emit(visibility_change{{m_opts.x_data.window, false}});
   } else {
-    m_sig.emit(visibility_change{true});
+    m_sig.emit(visibility_change{{m_opts.x_data.window, true}});
   }
 }
 
@@ -666,19 +670,39 @@ void bar::map_window() {
   reconfigure_pos();
 }
 
+/**
+ * Redraws the latest contents once the frame in flight was shown
+ *
+ * The frame may also be dropped without a completion event, the timer redraws the contents in that case.
+ */
+void bar::defer_frame() {
+  if (m_frame_deferred) {
+    m_log.trace("bar: Dropping superseded frame");
+  }
+  m_frame_deferred = true;
+
+  if (!m_frame_timer->is_active()) {
+    m_frame_timer->start(m_renderer->frame_timeout().count(), 0, [this]() {
+      if (m_frame_deferred) {
+        parse(m_lastinput, true);
+      }
+    });
+  }
+}
+
 void bar::trigger_click(mousebtn btn, int pos) {
   tags::action_t action = m_action_ctxt->has_action(btn, pos);
 
   if (action != tags::NO_ACTION) {
     m_log.trace("Found matching input area");
-    m_sig.emit(button_press{m_action_ctxt->get_action(action)});
+    m_sig.emit(button_press{{this, m_action_ctxt->get_action(action)}});
     return;
   }
 
   for (auto&& action : m_opts.actions) {
     if (action.button == btn && !action.command.empty()) {
       m_log.trace("Found matching fallback handler");
-      m_sig.emit(button_press{string{action.command}});
+      m_sig.emit(button_press{{this, string{action.command}}});
       return;
     }
   }
@@ -710,12 +734,13 @@ void bar::handle(const evt::destroy_notify& evt) {
  * Used to brighten the window by setting the
  * _NET_WM_WINDOW_OPACITY atom value
  */
-void bar::handle(const evt::enter_notify&) {
+void bar::handle(const evt::enter_notify& evt) {
+  if (evt->event != m_opts.x_data.window) {
+    return;
+  }
+
   if (m_opts.dimmed) {
-    m_dim_timer->start(25, 0, [this]() {
-      m_opts.dimmed = false;
-      m_sig.emit(dim_window{1.0});
-    });
+    m_dim_timer->start(25, 0, [this]() { dim(1.0); });
   } else if (m_dim_timer->is_active()) {
     m_dim_timer->stop();
   }
@@ -727,14 +752,15 @@ void bar::handle(const evt::enter_notify&) {
  * Used to dim the window by setting the
  * _NET_WM_WINDOW_OPACITY atom value
  */
-void bar::handle(const evt::leave_notify&) {
+void bar::handle(const evt::leave_notify& evt) {
+  if (evt->event != m_opts.x_data.window) {
+    return;
+  }
+
   // Only trigger dimming, if the dim-value is not fully opaque.
   if (m_opts.dimvalue < 1.0) {
     if (!m_opts.dimmed) {
-      m_dim_timer->start(3000, 0, [this]() {
-        m_opts.dimmed = true;
-        m_sig.emit(dim_window{double(m_opts.dimvalue)});
-      });
+      m_dim_timer->start(3000, 0, [this]() { dim(m_opts.dimvalue); });
     }
   }
 }
@@ -745,29 +771,36 @@ void bar::handle(const evt::leave_notify&) {
  * Used to change the cursor depending on the module
  */
 void bar::handle(const evt::motion_notify& evt) {
+  if (evt->event != m_opts.x_data.window) {
+    return;
+  }
+
   m_log.trace("bar: Detected motion: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
 #if WITH_XCURSOR
-  int motion_pos = evt->event_x;
+  m_motion_pos = evt->event_x;
+
+  if (!m_motion_timer->is_active()) {
+    m_motion_timer->start(0, 0, [this]() { update_cursor(m_motion_pos); });
+  }
+#endif
+}
+
+#if WITH_XCURSOR
+void bar::update_cursor(int motion_pos) {
+  static const tags::btn_mask click_buttons = tags::make_btn_mask({mousebtn::LEFT, mousebtn::MIDDLE, mousebtn::RIGHT,
+      mousebtn::DOUBLE_LEFT, mousebtn::DOUBLE_MIDDLE, mousebtn::DOUBLE_RIGHT});
+  static const tags::btn_mask scroll_buttons = tags::make_btn_mask({mousebtn::SCROLL_DOWN, mousebtn::SCROLL_UP});
+
   // scroll cursor is less important than click cursor, so we shouldn't return until we are sure there is no click
   // action
   bool found_scroll = false;
-  const auto has_action = [&](const vector<mousebtn>& buttons) -> bool {
-    for (auto btn : buttons) {
-      if (m_action_ctxt->has_action(btn, motion_pos) != tags::NO_ACTION) {
-        return true;
-      }
-    }
-
-    return false;
-  };
 
-  if (!m_opts.cursor_click.empty() && has_action({mousebtn::LEFT, mousebtn::MIDDLE, mousebtn::RIGHT,
-                                          mousebtn::DOUBLE_LEFT, mousebtn::DOUBLE_MIDDLE, mousebtn::DOUBLE_RIGHT})) {
+  if (!m_opts.cursor_click.empty() && m_action_ctxt->has_any_action(click_buttons, motion_pos)) {
     change_cursor(m_opts.cursor_click);
     return;
   }
 
-  if (!m_opts.cursor_scroll.empty() && has_action({mousebtn::SCROLL_DOWN, mousebtn::SCROLL_UP})) {
+  if (!m_opts.cursor_scroll.empty() && m_action_ctxt->has_any_action(scroll_buttons, motion_pos)) {
     change_cursor(m_opts.cursor_scroll);
     return;
   }
@@ -803,9 +836,8 @@ void bar::handle(const evt::motion_notify& evt) {
 
   m_log.trace("No matching cursor area found");
   change_cursor("default");
-  return;
-#endif
 }
+#endif
 
 /**
  * Event handler for XCB_BUTTON_PRESS events
@@ -813,6 +845,10 @@ void bar::handle(const evt::motion_notify& evt) {
  * Used to map mouse clicks to bar actions
  */
 void bar::handle(const evt::button_press& evt) {
+  if (evt->event != m_opts.x_data.window) {
+    return;
+  }
+
   m_log.trace("bar: Received button press: %i at pos(%i, %i)", evt->detail, evt->event_x, evt->event_y);
 
   mousebtn btn = static_cast<mousebtn>(evt->detail);
@@ -862,6 +898,9 @@ void bar::handle(const evt::expose& evt) {
     }
 
     m_log.trace("bar: Received expose event");
+    if (m_renderer->busy()) {
+      defer_frame();
+    }
     m_renderer->flush();
   }
 }
@@ -899,6 +938,11 @@ void bar::handle(const evt::configure_notify& evt) {
 void bar::start(const string& tray_module_name) {
   m_log.trace("bar: Create renderer");
   m_renderer = renderer::make(m_opts, *m_action_ctxt, m_conf);
+  m_renderer->on_frame_presented([this] {
+    if (m_frame_deferred) {
+      parse(m_lastinput, true);
+    }
+  });
 
   m_opts.x_data.window = m_renderer->window();
   m_opts.x_data.visual = m_renderer->visual();
@@ -937,10 +981,15 @@ void bar::start(const string& tray_module_name) {
   broadcast_visibility();
 }
 
-bool bar::on(const signals::ui::dim_window& sig) {
-  m_opts.dimmed = sig.cast() != 1.0;
-  ewmh_util::set_wm_window_opacity(m_opts.x_data.window, sig.cast() * 0xFFFFFFFF);
-  return false;
+/**
+ * Sets the opacity of the bar window
+ *
+ * The tray of this bar follows through the dim_window signal.
+ */
+void bar::dim(double value) {
+  m_opts.dimmed = value != 1.0;
+  ewmh_util::set_wm_window_opacity(m_opts.x_data.window, value * 0xFFFFFFFF);
+  m_sig.emit(dim_window{{m_opts.x_data.window, value}});
 }
 
 #if WITH_XCURSOR
@@ -9,7 +9,7 @@ namespace command_line {
    * Create instance
    */
   parser::make_type parser::make(string&& scriptname, const options&& opts) {
-    return std::make_unique<parser>("Usage: " + scriptname + " [OPTION]... [BAR]", forward<decltype(opts)>(opts));
+    return std::make_unique<parser>("Usage: " + scriptname + " [OPTION]... [BAR]...", forward<decltype(opts)>(opts));
   }
 
   /**
@@ -3,6 +3,7 @@
 #include <climits>
 #include <cmath>
 #include <fstream>
+#include <queue>
 
 #include "cairo/utils.hpp"
 #include "components/types.hpp"
@@ -52,6 +53,20 @@ void config::set_included(file_list included) {
   m_included = move(included);
 }
 
+config config::with_bar(string barname) const {
+  if (m_sections.find(BAR_PREFIX + barname) == m_sections.end()) {
+    throw application_error("Undefined bar: " + barname);
+  }
+
+  config conf(m_log, string{m_file}, move(barname));
+  conf.m_sections = m_sections;
+  conf.m_included = m_included;
+#if WITH_XRM
+  conf.m_xrm = m_xrm;
+#endif
+  return conf;
+}
+
 file_list config::get_included_files() const {
   return m_included;
 }
@@ -73,6 +88,101 @@ void config::warn_deprecated(const string& section, const string& key, string re
   }
 }
 
+bool config::section_changed(const config& other, const string& section, const std::set<string>& ignored_keys) const {
+  static const valuemap_t empty{};
+
+  auto it = m_sections.find(section);
+  auto other_it = other.m_sections.find(section);
+  const auto& values = it != m_sections.end() ? it->second : empty;
+  const auto& other_values = other_it != other.m_sections.end() ? other_it->second : empty;
+
+  // Values that were added or changed, references are followed below
+  std::queue<pair<string, string>> pending;
+
+  for (const auto& kv : values) {
+    if (ignored_keys.find(kv.first) == ignored_keys.end()) {
+      pending.emplace(section, kv.first);
+    }
+  }
+
+  // Values that were removed
+  for (const auto& kv : other_values) {
+    if (ignored_keys.find(kv.first) == ignored_keys.end() && values.find(kv.first) == values.end()) {
+      return true;
+    }
+  }
+
+  std::set<pair<string, string>> visited;
+
+  while (!pending.empty()) {
+    auto ref = pending.front();
+    pending.pop();
+
+    if (!visited.insert(ref).second) {
+      continue;
+    }
+
+    const string* value = find_raw(ref.first, ref.second);
+    const string* other_value = other.find_raw(ref.first, ref.second);
+
+    if (value == nullptr || other_value == nullptr) {
+      if (value != other_value) {
+        return true;
+      }
+      continue;
+    }
+
+    if (*value != *other_value) {
+      return true;
+    }
+
+    string ref_section;
+    string ref_key;
+    if (parse_local_reference(ref.first, *value, ref_section, ref_key)) {
+      pending.emplace(move(ref_section), move(ref_key));
+    }
+  }
+
+  return false;
+}
+
+bool config::depends_on_bar(const string& section) const {
+  auto it = m_sections.find(section);
+  if (it == m_sections.end()) {
+    return false;
+  }
+
+  const string bar_section = this->section();
+  std::queue<pair<string, string>> pending;
+  std::set<pair<string, string>> visited;
+
+  for (const auto& kv : it->second) {
+    pending.emplace(section, kv.first);
+  }
+
+  while (!pending.empty()) {
+    auto ref = pending.front();
+    pending.pop();
+
+    if (!visited.insert(ref).second) {
+      continue;
+    }
+
+    const string* value = find_raw(ref.first, ref.second);
+    string ref_section;
+    string ref_key;
+
+    if (value != nullptr && parse_local_reference(ref.first, *value, ref_section, ref_key)) {
+      if (ref_section == bar_section) {
+        return true;
+      }
+      pending.emplace(move(ref_section), move(ref_key));
+    }
+  }
+
+  return false;
+}
+
 /**
  * Returns true if a given parameter exists
  */
@@ -217,6 +327,42 @@ string config::dereference_local(string section, const string& key, const string
   }
 }
 
+bool config::parse_local_reference(
+    const string& current_section, const string& value, string& section, string& key) const {
+  if (value.size() < 3 || value.compare(0, 2, "${") != 0 || value.back() != '}') {
+    return false;
+  }
+
+  auto path = value.substr(2, value.length() - 3);
+  size_t pos;
+
+  if (path.compare(0, 4, "env:") == 0 || path.compare(0, 5, "xrdb:") == 0 || path.compare(0, 5, "file:") == 0 ||
+      (pos = path.find('.')) == string::npos) {
+    return false;
+  }
+
+  section = path.substr(0, pos);
+  key = path.substr(pos + 1, path.find(':', pos + 1) - pos - 1);
+
+  if (section == "BAR" || section == "root") {
+    section = this->section();
+  } else if (section == "self") {
+    section = current_section;
+  }
+
+  return true;
+}
+
+const string* config::find_raw(const string& section, const string& key) const {
+  auto it = m_sections.find(section);
+  if (it == m_sections.end()) {
+    return nullptr;
+  }
+
+  auto value = it->second.find(key);
+  return value != it->second.end() ? &value->second : nullptr;
+}
+
 /**
  * Dereference environment variable reference defined using:
  *  ${env:key}
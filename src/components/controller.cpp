@@ -1,14 +1,21 @@
 #include "components/controller.hpp"
 
-#include <csignal>
+#include <algorithm>
 #include <cassert>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "components/bar.hpp"
 #include "components/builder.hpp"
 #include "components/config.hpp"
+#include "components/config_parser.hpp"
 #include "components/eventloop.hpp"
 #include "components/logger.hpp"
+#include "components/startup_profiler.hpp"
 #include "components/types.hpp"
 #include "events/signal.hpp"
 #include "events/signal_emitter.hpp"
@@ -17,6 +24,7 @@
 #include "modules/meta/event_handler.hpp"
 #include "modules/meta/factory.hpp"
 #include "utils/actions.hpp"
+#include "utils/concurrency.hpp"
 #include "utils/inotify.hpp"
 #include "utils/process.hpp"
 #include "utils/string.hpp"
@@ -29,26 +37,49 @@ POLYBAR_NS
 using namespace eventloop;
 using namespace modules;
 
+/**
+ * Events with a lower code belong to the core protocol, the X server assigns the event codes of extensions from here on
+ */
+static constexpr uint8_t EXTENSION_EVENT_BASE{64};
+
+/**
+ * Bar settings listing the modules of each alignment block
+ */
+static const vector<pair<alignment, string>> BLOCK_KEYS{
+    {alignment::LEFT, "modules-left"}, {alignment::CENTER, "modules-center"}, {alignment::RIGHT, "modules-right"}};
+
 /**
  * Build controller instance
  */
-controller::make_type controller::make(bool has_ipc, loop& loop, const config& config) {
+controller::make_type controller::make(bool has_ipc, loop& loop, const vector<config>& confs) {
   return std::make_unique<controller>(
-      connection::make(), signal_emitter::make(), logger::make(), config, has_ipc, loop);
+      connection::make(), signal_emitter::make(), logger::make(), confs, has_ipc, loop);
 }
 
 /**
  * Construct controller
+ *
+ * One bar is created for each of the given configs, the first one is the main config.
  */
-controller::controller(
-    connection& conn, signal_emitter& emitter, const logger& logger, const config& config, bool has_ipc, loop& loop)
+controller::controller(connection& conn, signal_emitter& emitter, const logger& logger, const vector<config>& confs,
+    bool has_ipc, loop& loop)
     : m_connection(conn)
     , m_sig(emitter)
     , m_log(logger)
-    , m_conf(config)
+    , m_conf(confs.front())
     , m_loop(loop)
-    , m_bar(bar::make(m_loop, config))
     , m_has_ipc(has_ipc) {
+  auto& profiler = startup_profiler::make();
+
+  m_bars.reserve(confs.size());
+  for (const auto& conf : confs) {
+    auto timer = profiler.start("Create " + conf.section());
+    m_bars.emplace_back(conf, bar::make(m_loop, conf));
+  }
+
+  // Modules post their signals from their own threads
+  m_sig.set_wakeup([this] { m_notifier->send(); });
+
   m_conf.warn_deprecated("settings", "throttle-input-for");
   m_conf.warn_deprecated("settings", "throttle-output");
   m_conf.warn_deprecated("settings", "throttle-output-for");
@@ -57,9 +88,10 @@ controller::controller(
 
   m_log.trace("controller: Setup user-defined modules");
   size_t created_modules{0};
-  created_modules += setup_modules(alignment::LEFT);
-  created_modules += setup_modules(alignment::CENTER);
-  created_modules += setup_modules(alignment::RIGHT);
+  {
+    auto timer = profiler.start("Create modules");
+    created_modules = setup_modules();
+  }
 
   if (!created_modules) {
     throw application_error("No modules created");
@@ -75,6 +107,8 @@ controller::~controller() {
   m_log.trace("controller: Detach signal receiver");
   m_sig.detach(this);
 
+  m_log.info("controller: Dispatched %zu of %zu received X events", m_num_dispatched_events, m_num_raw_events);
+
   m_log.trace("controller: Stop modules");
   for (auto&& module : m_modules) {
     auto module_name = module->name();
@@ -85,6 +119,23 @@ controller::~controller() {
     });
     m_log.info("Deconstruction of %s took %lu ms.", module_name, cleanup_ms);
   }
+
+  m_sig.set_wakeup(nullptr);
+}
+
+controller::hosted_bar::hosted_bar(const config& conf, unique_ptr<polybar::bar>&& bar)
+    : conf(conf), bar(forward<decltype(bar)>(bar)) {}
+
+/**
+ * Checks whether the given module is displayed on this bar
+ */
+bool controller::hosted_bar::shows(const module_t& module) const {
+  for (const auto& block : blocks) {
+    if (std::find(block.second.begin(), block.second.end(), module) != block.second.end()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 /**
@@ -113,10 +164,25 @@ bool controller::run(bool writeback, string snapshot_dst, bool confwatch) {
 /**
  * Enqueue input data
  */
-void controller::trigger_action(string&& input_data) {
+void controller::trigger_action(string&& input_data, const bar* source) {
   std::unique_lock<std::mutex> guard(m_notification_mutex);
   m_log.trace("controller: Queueing input event '%s'", input_data);
-  m_notifications.inputdata.push(std::move(input_data));
+  m_notifications.inputdata.emplace(source, std::move(input_data));
+  trigger_notification();
+}
+
+/**
+ * Enqueue multiple actions at once
+ *
+ * All actions are processed in the same iteration of the eventloop, so the bar is only redrawn once all of them were
+ * applied.
+ */
+void controller::trigger_actions(vector<string>&& actions) {
+  std::unique_lock<std::mutex> guard(m_notification_mutex);
+  m_log.trace("controller: Queueing %zu input events", actions.size());
+  for (auto&& action : actions) {
+    m_notifications.inputdata.emplace(nullptr, std::move(action));
+  }
   trigger_notification();
 }
 
@@ -135,8 +201,16 @@ void controller::trigger_update(bool force) {
   trigger_notification();
 }
 
+/**
+ * Wakes up the eventloop to process m_notifications
+ *
+ * Must be called while holding m_notification_mutex.
+ */
 void controller::trigger_notification() {
-  m_notifier->send();
+  // The notifications are processed right after the posted signals, waking up the eventloop again is not necessary
+  if (!m_dispatching_posted) {
+    m_notifier->send();
+  }
 }
 
 void controller::stop(bool reload) {
@@ -152,8 +226,55 @@ void controller::conn_cb() {
     return;
   }
 
-  shared_ptr<xcb_generic_event_t> evt{};
-  while ((evt = m_connection.poll_for_event()) != nullptr) {
+  /*
+   * First drain all pending events so that redundant ones can be dropped before any of them is dispatched.
+   */
+  shared_ptr<xcb_generic_event_t> pending{};
+  while ((pending = m_connection.poll_for_event()) != nullptr) {
+    m_event_batch.push_back(std::move(pending));
+  }
+
+  if (m_event_batch.empty()) {
+    return;
+  }
+
+  size_t num_raw = m_event_batch.size();
+  coalesce_events(m_event_batch);
+
+  m_num_raw_events += num_raw;
+  m_num_dispatched_events += m_event_batch.size();
+  m_log.trace_x("controller: Dispatching %zu of %zu X events", m_event_batch.size(), num_raw);
+
+  for (const auto& evt : m_event_batch) {
+    /*
+     * Errors of unchecked requests are delivered through the event queue. The component that sent the request can
+     * claim it through the x_error signal.
+     */
+    if (evt->response_type == 0) {
+      auto* error = reinterpret_cast<const xcb_generic_error_t*>(evt.get());
+      if (!m_sig.emit(signals::ui::x_error{std::make_pair(error->error_code, error->resource_id)})) {
+        m_log.trace("controller: Unhandled X error %d (resource: 0x%x, request: %d)", error->error_code,
+            error->resource_id, error->major_code);
+      }
+      continue;
+    }
+
+    /*
+     * Generic events and the events of some extensions (e.g. MIT-SHM completions) are not known to the event
+     * registry, they are handled by the component that selected them.
+     */
+    uint8_t type = evt->response_type & ~0x80;
+    if (type == XCB_GE_GENERIC || type >= EXTENSION_EVENT_BASE) {
+      const xcb_generic_event_t* generic = evt.get();
+      if (m_sig.emit(signals::ui::x_generic_event{generic})) {
+        continue;
+      } else if (type == XCB_GE_GENERIC) {
+        m_log.trace("controller: Unhandled generic X event (extension: %d)",
+            reinterpret_cast<const xcb_ge_generic_event_t*>(generic)->extension);
+        continue;
+      }
+    }
+
     try {
       m_connection.dispatch_event(evt);
     } catch (xpp::connection_error& err) {
@@ -165,6 +286,8 @@ void controller::conn_cb() {
     }
   }
 
+  m_event_batch.clear();
+
   if ((xcb_error = m_connection.connection_has_error()) != 0) {
     m_log.err("X connection error, terminating... (what: %s)", m_connection.error_str(xcb_error));
     stop(false);
@@ -172,6 +295,90 @@ void controller::conn_cb() {
   }
 }
 
+/**
+ * Removes redundant events from a batch of X events
+ *
+ * - Only the latest MotionNotify event per window is kept
+ * - Expose events for the same window are merged into the latest one, whose
+ *   area is extended to cover all of them
+ * - Only the latest PropertyNotify event per window, atom, and state is kept,
+ *   so a NewValue is never merged with a Delete
+ *
+ * All other events are kept and the relative order of the remaining events
+ * does not change.
+ */
+void controller::coalesce_events(vector<shared_ptr<xcb_generic_event_t>>& events) {
+  std::unordered_map<xcb_window_t, size_t> last_motion;
+  std::unordered_map<xcb_window_t, size_t> last_expose;
+  std::map<std::tuple<xcb_window_t, xcb_atom_t, uint8_t>, size_t> last_property;
+
+  for (size_t i = 0; i < events.size(); i++) {
+    auto* evt = events[i].get();
+    switch (evt->response_type & ~0x80) {
+      case XCB_MOTION_NOTIFY:
+        last_motion[reinterpret_cast<xcb_motion_notify_event_t*>(evt)->event] = i;
+        break;
+      case XCB_EXPOSE:
+        last_expose[reinterpret_cast<xcb_expose_event_t*>(evt)->window] = i;
+        break;
+      case XCB_PROPERTY_NOTIFY: {
+        auto* property = reinterpret_cast<xcb_property_notify_event_t*>(evt);
+        last_property[std::make_tuple(property->window, property->atom, property->state)] = i;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  if (last_motion.empty() && last_expose.empty() && last_property.empty()) {
+    return;
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < events.size(); i++) {
+    auto* evt = events[i].get();
+    bool keep = true;
+
+    switch (evt->response_type & ~0x80) {
+      case XCB_MOTION_NOTIFY:
+        keep = last_motion[reinterpret_cast<xcb_motion_notify_event_t*>(evt)->event] == i;
+        break;
+      case XCB_EXPOSE: {
+        auto* expose = reinterpret_cast<xcb_expose_event_t*>(evt);
+        size_t last = last_expose[expose->window];
+
+        if (last != i) {
+          auto* target = reinterpret_cast<xcb_expose_event_t*>(events[last].get());
+          int x1 = std::min(target->x, expose->x);
+          int y1 = std::min(target->y, expose->y);
+          int x2 = std::max(target->x + target->width, expose->x + expose->width);
+          int y2 = std::max(target->y + target->height, expose->y + expose->height);
+          target->x = x1;
+          target->y = y1;
+          target->width = x2 - x1;
+          target->height = y2 - y1;
+          keep = false;
+        }
+        break;
+      }
+      case XCB_PROPERTY_NOTIFY: {
+        auto* property = reinterpret_cast<xcb_property_notify_event_t*>(evt);
+        keep = last_property[std::make_tuple(property->window, property->atom, property->state)] == i;
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (keep) {
+      events[kept++] = std::move(events[i]);
+    }
+  }
+
+  events.resize(kept);
+}
+
 void controller::signal_handler(int signum) {
   m_log.notice("Received signal(%d): %s", signum, strsignal(signum));
   stop(signum == SIGUSR1);
@@ -185,18 +392,54 @@ void controller::create_config_watcher(const string& filename) {
         m_log.err("libuv error while watching included file for changes: %s", uv_strerror(e.status));
         handle.close();
       });
+  m_config_watchers[filename] = fs_event_handle;
+}
+
+/**
+ * (Re)creates the watchers for the current config file and all its included files
+ *
+ * Editors often save files by replacing them, the watchers are recreated so that they follow the new files.
+ */
+void controller::watch_config_files() {
+  for (auto&& watcher : m_config_watchers) {
+    watcher.second->close();
+  }
+  m_config_watchers.clear();
+
+  const config& conf = current_config();
+  create_config_watcher(conf.filepath());
+  // also watch the include-files for changes
+  for (auto& module_path : conf.get_included_files()) {
+    if (m_config_watchers.find(module_path) == m_config_watchers.end()) {
+      create_config_watcher(module_path);
+    }
+  }
 }
 
 void controller::confwatch_handler(const char* filename) {
   m_log.notice("Watched config file changed %s", filename);
-  stop(true);
+
+  if (!reload_config()) {
+    stop(true);
+    return;
+  }
+
+  watch_config_files();
 }
 
 void controller::notifier_handler() {
+  {
+    std::unique_lock<std::mutex> guard(m_notification_mutex);
+    m_dispatching_posted = true;
+  }
+
+  m_sig.dispatch_posted();
+
   notifications_t data{};
 
   {
     std::unique_lock<std::mutex> guard(m_notification_mutex);
+    m_dispatching_posted = false;
     std::swap(m_notifications, data);
   }
 
@@ -208,8 +451,8 @@ void controller::notifier_handler() {
   while (!data.inputdata.empty()) {
     auto inputdata = data.inputdata.front();
     data.inputdata.pop();
-    m_log.trace("controller: Dequeueing inputdata: '%s'", inputdata);
-    process_inputdata(std::move(inputdata));
+    m_log.trace("controller: Dequeueing inputdata: '%s'", inputdata.second);
+    process_inputdata(std::move(inputdata.second), inputdata.first);
   }
 
   if (data.update) {
@@ -218,25 +461,15 @@ void controller::notifier_handler() {
 }
 
 void controller::screenshot_handler() {
-  m_sig.emit(signals::ui::request_snapshot{move(m_snapshot_dst)});
+  m_sig.emit(signals::ui::request_snapshot{{m_bars.front().bar->settings().x_data.window, move(m_snapshot_dst)}});
   trigger_update(true);
 }
 
 void controller::start_modules() {
   size_t started_modules{0};
   for (const auto& module : m_modules) {
-    auto evt_handler = dynamic_cast<event_handler_interface*>(&*module);
-
-    if (evt_handler != nullptr) {
-      evt_handler->connect(m_connection);
-    }
-
-    try {
-      m_log.info("Starting %s", module->name());
-      module->start();
+    if (start_module(module)) {
       started_modules++;
-    } catch (const application_error& err) {
-      m_log.err("Failed to start '%s' (reason: %s)", module->name(), err.what());
     }
   }
 
@@ -245,17 +478,206 @@ void controller::start_modules() {
   }
 }
 
+bool controller::start_module(const module_t& module) {
+  auto evt_handler = dynamic_cast<event_handler_interface*>(&*module);
+
+  if (evt_handler != nullptr) {
+    evt_handler->connect(m_connection);
+  }
+
+  try {
+    m_log.info("Starting %s", module->name());
+    module->start();
+    return true;
+  } catch (const application_error& err) {
+    m_log.err("Failed to start '%s' (reason: %s)", module->name(), err.what());
+    return false;
+  }
+}
+
+/**
+ * Reloads the config file without restarting the application
+ *
+ * Only modules whose config changed are recreated, all other modules keep running. Changes to the bar, the tray or
+ * the global settings can't be applied in place.
+ *
+ * @returns false if the application has to be restarted to apply the new config
+ */
+bool controller::reload_config() {
+  if (m_bars.size() > 1) {
+    m_log.notice("Config changed while hosting multiple bars, restarting...");
+    return false;
+  }
+
+  const config& current = current_config();
+  hosted_bar& target = m_bars.front();
+  shared_ptr<const config> conf;
+
+  try {
+    config_parser parser{m_log, string{current.filepath()}};
+    conf = make_shared<config>(parser.parse(current.section().substr(strlen(config::BAR_PREFIX))));
+  } catch (const exception& err) {
+    m_log.err("Failed to reload config, keeping the current one (reason: %s)", err.what());
+    return true;
+  }
+
+  if (conf->section_changed(current, "settings")) {
+    m_log.notice("Global settings changed, restarting...");
+    return false;
+  }
+
+  std::set<string> ignored_keys;
+  for (const auto& block : BLOCK_KEYS) {
+    ignored_keys.insert(block.second);
+  }
+
+  if (conf->section_changed(current, conf->section(), ignored_keys)) {
+    m_log.notice("Bar settings changed, restarting...");
+    return false;
+  }
+
+  std::map<alignment, vector<string>> module_names;
+  string tray_module_name;
+
+  for (const auto& block : BLOCK_KEYS) {
+    for (auto& module_name : string_util::split(conf->get(conf->section(), block.second, ""s), ' ')) {
+      if (module_name.empty()) {
+        continue;
+      }
+
+      if (conf->get("module/" + module_name, "type", ""s) == tray_module::TYPE) {
+        if (tray_module_name.empty()) {
+          tray_module_name = module_name;
+        } else {
+          m_log.err("Disabling module \"%s\" (reason: Multiple trays defined. Using tray `%s`)", module_name,
+              tray_module_name);
+          continue;
+        }
+      }
+
+      module_names[block.first].emplace_back(move(module_name));
+    }
+  }
+
+  if (tray_module_name != target.tray_module_name ||
+      (!tray_module_name.empty() && conf->section_changed(current, "module/" + tray_module_name))) {
+    m_log.notice("Tray settings changed, restarting...");
+    return false;
+  }
+
+  std::unordered_map<string, vector<module_t>> unchanged;
+  for (const auto& module : m_modules) {
+    if (module->running() && !conf->section_changed(current, module->name())) {
+      unchanged[module->name_raw()].push_back(module);
+    }
+  }
+
+  vector<pair<alignment, module_t>> entries;
+  vector<module_request> requests;
+  vector<size_t> new_entries;
+
+  for (const auto& block : module_names) {
+    for (const auto& module_name : block.second) {
+      auto it = unchanged.find(module_name);
+
+      if (it != unchanged.end() && !it->second.empty()) {
+        entries.emplace_back(block.first, it->second.back());
+        it->second.pop_back();
+      } else {
+        requests.push_back({module_name, target.bar->settings(), *conf});
+        new_entries.push_back(entries.size());
+        entries.emplace_back(block.first, nullptr);
+      }
+    }
+  }
+
+  vector<module_t> created;
+  auto new_modules = create_modules(requests);
+  for (size_t i = 0; i < new_modules.size(); i++) {
+    if (new_modules[i]) {
+      entries[new_entries[i]].second = new_modules[i];
+      created.push_back(new_modules[i]);
+    }
+  }
+
+  vector<module_t> modules;
+  modulemap_t blocks;
+
+  for (auto&& entry : entries) {
+    if (entry.second) {
+      modules.push_back(entry.second);
+      blocks[entry.first].push_back(move(entry.second));
+    }
+  }
+
+  if (modules.empty()) {
+    m_log.err("Failed to reload config, keeping the current one (reason: No modules created)");
+    return true;
+  }
+
+  for (const auto& module : created) {
+    m_module_confs[module.get()] = conf;
+  }
+
+  /*
+   * New modules are started before the old ones are stopped, otherwise stopping the last old module would make the
+   * controller quit.
+   */
+  for (const auto& module : created) {
+    start_module(module);
+  }
+
+  std::swap(m_modules, modules);
+  target.blocks = move(blocks);
+  m_reloaded_conf = conf;
+
+  vector<const module_interface*> removed;
+  for (auto&& module : modules) {
+    if (std::find(m_modules.begin(), m_modules.end(), module) != m_modules.end()) {
+      continue;
+    }
+
+    auto evt_handler = dynamic_cast<event_handler_interface*>(&*module);
+    if (evt_handler != nullptr) {
+      evt_handler->disconnect(m_connection);
+    }
+
+    m_log.info("Stopping %s", module->name());
+    module->stop();
+    module->join();
+    removed.push_back(module.get());
+  }
+
+  modules.clear();
+  for (const auto* module : removed) {
+    m_module_confs.erase(module);
+  }
+
+  m_log.notice("Reloaded config (%zu modules recreated, %zu removed)", created.size(), removed.size());
+
+  trigger_update(true);
+  return true;
+}
+
 /**
  * Read events from configured file descriptors
  */
 void controller::read_events(bool confwatch) {
   m_log.info("Entering event loop (thread-id=%lu)", this_thread::get_id());
 
+  auto& profiler = startup_profiler::make();
+
   if (!m_writeback) {
-    m_bar->start(m_tray_module_name);
+    auto timer = profiler.start("Start bar");
+    for (auto&& hosted : m_bars) {
+      hosted.bar->start(hosted.tray_module_name);
+    }
   }
 
-  start_modules();
+  {
+    auto timer = profiler.start("Start modules");
+    start_modules();
+  }
 
   auto x_poll_handle = m_loop.handle<PollHandle>(m_connection.get_file_descriptor());
   x_poll_handle->start(
@@ -282,11 +704,7 @@ void controller::read_events(bool confwatch) {
   }
 
   if (confwatch) {
-    create_config_watcher(m_conf.filepath());
-    // also watch the include-files for changes
-    for (auto& module_path : m_conf.get_included_files()) {
-      create_config_watcher(module_path);
-    }
+    watch_config_files();
   }
 
   if (!m_snapshot_dst.empty()) {
@@ -424,7 +842,12 @@ bool controller::try_forward_legacy_action(const string& cmd) {
   return false;
 }
 
-bool controller::forward_action(const actions_util::action& action_triple) {
+/**
+ * Forwards the action to all modules with a matching name
+ *
+ * If the action was triggered on a bar, it is only delivered to the modules displayed on that bar.
+ */
+bool controller::forward_action(const actions_util::action& action_triple, const bar* source) {
   string module_name = std::get<0>(action_triple);
   string action = std::get<1>(action_triple);
   string data = std::get<2>(action_triple);
@@ -435,7 +858,15 @@ bool controller::forward_action(const actions_util::action& action_triple) {
 
   // Forwards the action to all modules that match the name
   for (auto&& module : m_modules) {
-    if (module->name_raw() == module_name) {
+    if (module->name_raw() != module_name) {
+      continue;
+    }
+
+    auto shown = [&module, source](const hosted_bar& hosted) {
+      return hosted.bar.get() == source && hosted.shows(module);
+    };
+
+    if (source == nullptr || std::any_of(m_bars.begin(), m_bars.end(), shown)) {
       if (!module->input(action, data)) {
         m_log.err("The '%s' module does not support the '%s' action.", module_name, action);
       }
@@ -456,13 +887,13 @@ bool controller::forward_action(const actions_util::action& action_triple) {
 /**
  * Process stored input data
  */
-void controller::process_inputdata(string&& cmd) {
+void controller::process_inputdata(string&& cmd, const bar* source) {
   m_log.trace("controller: Processing inputdata: %s", cmd);
 
   // Every command that starts with '#' is considered an action string.
   if (cmd.front() == '#') {
     try {
-      this->forward_action(actions_util::parse_action_string(cmd));
+      this->forward_action(actions_util::parse_action_string(cmd), source);
     } catch (runtime_error& e) {
       m_log.err("Invalid action string (action: %s, reason: %s)", cmd, e.what());
     }
@@ -486,95 +917,131 @@ void controller::process_inputdata(string&& cmd) {
 }
 
 /**
- * Process eventqueue update event
+ * Builds the formatted contents of a bar from its modules
+ *
+ * Module outputs are compared by their generation, the contents are only assembled if one of the displayed modules
+ * changed since the last call or if force is set.
+ *
+ * @returns nullptr if the contents did not change
  */
-bool controller::process_update(bool force) {
-  const bar_settings& bar{m_bar->settings()};
-  string contents;
-  string padding_left = builder::get_spacing_format_string(bar.padding.left);
-  string padding_right = builder::get_spacing_format_string(bar.padding.right);
-  string margin_left = builder::get_spacing_format_string(bar.module_margin.left);
-  string margin_right = builder::get_spacing_format_string(bar.module_margin.right);
+shared_ptr<const string> controller::bar_contents(hosted_bar& target, bool force) const {
+  vector<pair<const modules::module_interface*, size_t>> generations;
+  vector<vector<shared_ptr<const string>>> outputs;
+  size_t size = 0;
 
-  builder build{bar};
-  build.node(bar.separator);
-  string separator{build.flush()};
-
-  for (const auto& block : m_blocks) {
-    string block_contents;
-    bool is_left = false;
-    bool is_center = false;
-    bool is_right = false;
-    bool is_first = true;
-
-    if (block.first == alignment::LEFT) {
-      is_left = true;
-    } else if (block.first == alignment::CENTER) {
-      is_center = true;
-    } else if (block.first == alignment::RIGHT) {
-      is_right = true;
-    }
+  for (const auto& block : target.blocks) {
+    outputs.emplace_back();
 
     for (const auto& module : block.second) {
       if (!module->running() || !module->visible()) {
         continue;
       }
 
-      string module_contents;
-
       try {
-        module_contents = module->contents();
+        auto module_contents = module->contents();
+        generations.emplace_back(module.get(), module->generation());
+
+        if (!module_contents->empty()) {
+          size += module_contents->size();
+          outputs.back().emplace_back(move(module_contents));
+        }
       } catch (const exception& err) {
         m_log.err("Failed to get contents for \"%s\" (err: %s)", module->name(), err.what());
       }
+    }
 
-      if (module_contents.empty()) {
-        continue;
-      }
+    generations.emplace_back(nullptr, 0);
+  }
 
-      if (!block_contents.empty() && !margin_right.empty()) {
-        block_contents += margin_right;
-      }
+  if (!force && generations == target.generations) {
+    return nullptr;
+  }
 
-      if (!block_contents.empty() && !separator.empty()) {
-        block_contents += separator;
-      }
+  target.generations = move(generations);
 
-      if (!block_contents.empty() && !margin_left.empty() && !(is_left && is_first)) {
-        block_contents += margin_left;
-      }
+  const bar_settings& bar{target.bar->settings()};
+  string padding_left = builder::get_spacing_format_string(bar.padding.left);
+  string padding_right = builder::get_spacing_format_string(bar.padding.right);
+  string margin_left = builder::get_spacing_format_string(bar.module_margin.left);
+  string margin_right = builder::get_spacing_format_string(bar.module_margin.right);
+
+  builder build{bar};
+  build.node(bar.separator);
+  string separator{build.flush()};
 
-      block_contents.reserve(module_contents.size());
-      block_contents += module_contents;
+  // Enough for all module outputs, the spacing between them and the alignment tags
+  string contents;
+  contents.reserve(size + target.generations.size() * (margin_left.size() + margin_right.size() + separator.size()) +
+                   padding_left.size() + padding_right.size() + 12);
 
-      is_first = false;
-    }
+  auto block_output = outputs.begin();
+  for (const auto& block : target.blocks) {
+    const auto& block_outputs = *block_output++;
 
-    if (block_contents.empty()) {
+    if (block_outputs.empty()) {
       continue;
-    } else if (is_left) {
+    }
+
+    if (block.first == alignment::LEFT) {
       contents += "%{l}";
       contents += padding_left;
-    } else if (is_center) {
+    } else if (block.first == alignment::CENTER) {
       contents += "%{c}";
-    } else if (is_right) {
+    } else if (block.first == alignment::RIGHT) {
       contents += "%{r}";
-      block_contents += padding_right;
     }
 
-    contents += block_contents;
+    bool is_first = true;
+    for (const auto& module_contents : block_outputs) {
+      if (!is_first) {
+        contents += margin_right;
+        contents += separator;
+        contents += margin_left;
+      }
+
+      contents += *module_contents;
+      is_first = false;
+    }
+
+    if (block.first == alignment::RIGHT) {
+      contents += padding_right;
+    }
   }
 
-  try {
-    if (!m_writeback) {
-      m_bar->parse(move(contents), force);
-    } else {
-      std::cout << contents << std::endl;
+  return std::make_shared<const string>(move(contents));
+}
+
+/**
+ * Process eventqueue update event
+ */
+bool controller::process_update(bool force) {
+  auto timer = startup_profiler::make().start("Update bar");
+
+  for (auto&& hosted : m_bars) {
+    // Lines written to stdout are not compared, every update is written
+    auto contents = bar_contents(hosted, force || m_writeback);
+
+    if (!contents) {
+      m_log.trace("controller: Ignoring update (unchanged)");
+      continue;
+    }
+
+    try {
+      if (!m_writeback) {
+        hosted.bar->parse(move(contents), force);
+      } else {
+        std::cout << *contents << std::endl;
+      }
+    } catch (const exception& err) {
+      m_log.err("Failed to update bar contents (reason: %s)", err.what());
     }
-  } catch (const exception& err) {
-    m_log.err("Failed to update bar contents (reason: %s)", err.what());
   }
 
+  timer.reset();
+
+  // Only reports once, after the first update
+  startup_profiler::make().report(m_log);
+
   return true;
 }
 
@@ -583,64 +1050,161 @@ void controller::update_reload(bool reload) {
 }
 
 /**
- * Creates module instances for all the modules in the given alignment block
+ * Checks whether a module instance created for bar `a` can also be displayed on bar `b`
+ *
+ * Modules use the bar settings for their formatting, so they are only shared between bars that format modules the
+ * same way.
+ */
+static bool same_module_settings(const bar_settings& a, const bar_settings& b) {
+  return a.spacing.type == b.spacing.type && a.spacing.value == b.spacing.value && a.foreground == b.foreground &&
+         a.background == b.background && a.locale == b.locale;
+}
+
+/**
+ * Creates module instances for the modules of all alignment blocks of all bars
+ *
+ * If multiple bars display the same module, a single instance is shared between them as long as the module does
+ * not depend on the bar it is displayed on.
  */
-size_t controller::setup_modules(alignment align) {
-  string key;
+size_t controller::setup_modules() {
+  vector<module_request> requests;
+  // Indices of the bars each request is displayed on
+  vector<vector<size_t>> request_bars;
+  // Requests displayed in each block of each bar, in order
+  vector<std::map<alignment, vector<size_t>>> layout(m_bars.size());
+  std::unordered_map<string, vector<size_t>> requests_by_name;
+  string tray_module_name;
+
+  for (size_t bar_index = 0; bar_index < m_bars.size(); bar_index++) {
+    auto& hosted = m_bars[bar_index];
+    const config& conf = hosted.conf;
+    const bar_settings& settings = hosted.bar->settings();
+
+    for (const auto& block : BLOCK_KEYS) {
+      for (auto& module_name : string_util::split(conf.get(conf.section(), block.second, ""s), ' ')) {
+        if (module_name.empty()) {
+          continue;
+        }
 
-  switch (align) {
-    case alignment::LEFT:
-      key = "modules-left";
-      break;
+        auto type = conf.get("module/" + module_name, "type", ""s);
 
-    case alignment::CENTER:
-      key = "modules-center";
-      break;
+        if (type == tray_module::TYPE) {
+          if (!tray_module_name.empty()) {
+            m_log.err("Disabling module \"%s\" (reason: Multiple trays defined. Using tray `%s`)", module_name,
+                tray_module_name);
+            continue;
+          }
+          tray_module_name = module_name;
+          hosted.tray_module_name = module_name;
+        }
 
-    case alignment::RIGHT:
-      key = "modules-right";
-      break;
+        auto& candidates = requests_by_name[module_name];
+        auto shared = candidates.end();
 
-    case alignment::NONE:
-      m_log.err("controller: Tried to setup modules for alignment NONE");
-      break;
-  }
+        if (m_bars.size() > 1 && !modules::is_bar_specific(type) && !conf.depends_on_bar("module/" + module_name)) {
+          shared = std::find_if(candidates.begin(), candidates.end(), [&](size_t candidate) {
+            const auto& bars = request_bars[candidate];
+            return std::find(bars.begin(), bars.end(), bar_index) == bars.end() &&
+                   same_module_settings(requests[candidate].bar, settings);
+          });
+        }
 
-  string configured_modules;
-  if (!key.empty()) {
-    configured_modules = m_conf.get(m_conf.section(), key, ""s);
-  }
+        size_t request;
+        if (shared != candidates.end()) {
+          request = *shared;
+          request_bars[request].push_back(bar_index);
+        } else {
+          request = requests.size();
+          candidates.push_back(request);
+          requests.push_back({move(module_name), settings, conf});
+          request_bars.push_back({bar_index});
+        }
 
-  for (auto& module_name : string_util::split(configured_modules, ' ')) {
-    if (module_name.empty()) {
-      continue;
+        layout[bar_index][block.first].push_back(request);
+      }
     }
+  }
 
-    try {
-      auto type = m_conf.get("module/" + module_name, "type");
+  auto modules = create_modules(requests);
 
-      if (type == tray_module::TYPE) {
-        if (!m_tray_module_name.empty()) {
-          throw module_error("Multiple trays defined. Using tray `" + m_tray_module_name + "`");
+  for (size_t bar_index = 0; bar_index < m_bars.size(); bar_index++) {
+    for (const auto& block : layout[bar_index]) {
+      for (auto request : block.second) {
+        if (modules[request]) {
+          m_bars[bar_index].blocks[block.first].push_back(modules[request]);
         }
-        m_tray_module_name = module_name;
       }
+    }
+  }
 
-      if (type == ipc_module::TYPE && !m_has_ipc) {
-        throw application_error("Inter-process messaging needs to be enabled");
-      }
+  for (auto&& module : modules) {
+    if (module) {
+      m_modules.push_back(move(module));
+    }
+  }
 
-      m_log.notice("Loading module '%s' of type '%s'", module_name, type);
-      module_t module = modules::make_module(move(type), m_bar->settings(), module_name, m_log, m_conf);
+  if (m_bars.size() > 1) {
+    auto shared_modules = std::count_if(
+        request_bars.begin(), request_bars.end(), [](const vector<size_t>& bars) { return bars.size() > 1; });
+    m_log.info("controller: %zd modules are shared between %zu bars", shared_modules, m_bars.size());
+  }
 
-      m_modules.push_back(module);
-      m_blocks[align].push_back(module);
+  return m_modules.size();
+}
+
+/**
+ * Creates module instances for the given requests
+ *
+ * Module constructors may block (e.g. while connecting to a server), so modules are created on a small thread pool.
+ * Only modules that need the main thread are created on the calling thread.
+ *
+ * @returns The created modules in the same order as the requests. Modules that couldn't be created are logged and
+ *          left empty.
+ */
+vector<module_t> controller::create_modules(const vector<module_request>& requests) {
+  vector<module_t> modules(requests.size());
+  vector<size_t> pooled;
+  auto& profiler = startup_profiler::make();
+
+  auto create = [&](size_t i) {
+    const auto& request = requests[i];
+    auto timer = profiler.start("Create module/" + request.name);
+    try {
+      modules[i] = create_module(request.name, request.bar, request.conf);
     } catch (const std::exception& err) {
-      m_log.err("Disabling module \"%s\" (reason: %s)", module_name, err.what());
+      m_log.err("Disabling module \"%s\" (reason: %s)", request.name, err.what());
+    }
+  };
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    if (modules::needs_main_thread(requests[i].conf.get("module/" + requests[i].name, "type", ""s))) {
+      create(i);
+    } else {
+      pooled.push_back(i);
     }
   }
 
-  return m_blocks[align].size();
+  concurrency_util::parallel_for(pooled.size(), [&](size_t i) { create(pooled[i]); });
+
+  return modules;
+}
+
+/**
+ * Creates a single module instance for the given bar
+ */
+module_t controller::create_module(const string& name, const bar_settings& bar, const config& conf) {
+  auto type = conf.get("module/" + name, "type");
+
+  if (type == ipc_module::TYPE && !m_has_ipc) {
+    throw application_error("Inter-process messaging needs to be enabled");
+  }
+
+  m_log.notice("Loading module '%s' of type '%s'", name, type);
+  return modules::make_module(move(type), bar, name, m_log, conf);
+}
+
+const config& controller::current_config() const {
+  return m_reloaded_conf ? *m_reloaded_conf : m_conf;
 }
 
 /**
@@ -685,14 +1249,14 @@ bool controller::on(const signals::eventqueue::check_state&) {
  * Process ui button press event
  */
 bool controller::on(const signals::ui::button_press& evt) {
-  string input{evt.cast()};
+  auto input = evt.cast();
 
-  if (input.empty()) {
+  if (input.second.empty()) {
     m_log.err("Cannot enqueue empty input");
     return false;
   }
 
-  trigger_action(move(input));
+  trigger_action(move(input.second), input.first);
   return true;
 }
 
@@ -712,6 +1276,22 @@ bool controller::on(const signals::ipc::action& evt) {
   return true;
 }
 
+/**
+ * Process ipc action batches
+ */
+bool controller::on(const signals::ipc::batch& evt) {
+  auto actions = evt.cast();
+
+  if (actions.empty()) {
+    m_log.err("Cannot enqueue empty ipc batch");
+    return false;
+  }
+
+  m_log.info("Enqueuing ipc batch of %zu actions", actions.size());
+  trigger_actions(move(actions));
+  return true;
+}
+
 /**
  * Process ipc command messages
  */
@@ -727,11 +1307,17 @@ bool controller::on(const signals::ipc::command& evt) {
   } else if (command == "restart") {
     trigger_quit(true);
   } else if (command == "hide") {
-    m_bar->hide();
+    for (auto&& hosted : m_bars) {
+      hosted.bar->hide();
+    }
   } else if (command == "show") {
-    m_bar->show();
+    for (auto&& hosted : m_bars) {
+      hosted.bar->show();
+    }
   } else if (command == "toggle") {
-    m_bar->toggle();
+    for (auto&& hosted : m_bars) {
+      hosted.bar->toggle();
+    }
   } else {
     m_log.warn("\"%s\" is not a valid ipc command", command);
     return false;
@@ -2,6 +2,8 @@
 
 #include <unistd.h>
 
+#include <cerrno>
+
 #include "errors.hpp"
 #include "settings.hpp"
 #include "utils/concurrency.hpp"
@@ -66,6 +68,25 @@ logger::logger(loglevel level) : m_level(level) {
   // clang-format on
 }
 
+/**
+ * Deconstruct logger
+ *
+ * Stops the flusher thread and writes all remaining messages
+ */
+logger::~logger() {
+  {
+    std::lock_guard<std::mutex> guard(m_flusher_mutex);
+    m_stopped = true;
+  }
+  m_flusher_cv.notify_one();
+
+  if (m_flusher.joinable()) {
+    m_flusher.join();
+  }
+
+  drain();
+}
+
 /**
  * Set output verbosity
  */
@@ -78,6 +99,96 @@ void logger::verbosity(loglevel level) {
   m_level = level;
 }
 
+/**
+ * Write all queued messages on the calling thread
+ *
+ * Has to be called before the process image is replaced, queued messages would be lost otherwise.
+ */
+void logger::flush() const {
+  drain();
+}
+
+/**
+ * Queue a formatted message for the flusher thread
+ *
+ * Errors are written right away (after all queued messages) so that they are not lost if the application crashes.
+ * If the queue is full, the message is dropped and counted instead of blocking the caller.
+ */
+void logger::enqueue(loglevel level, string&& message) const {
+  if (level == loglevel::ERROR) {
+    drain();
+    std::lock_guard<std::mutex> guard(m_write_mutex);
+    write_all(message);
+    return;
+  }
+
+  std::call_once(m_flusher_started, [this] { m_flusher = std::thread(&logger::run_flusher, this); });
+
+  if (!m_queue.push(move(message))) {
+    m_dropped++;
+  }
+
+  // Wake the flusher early if the queue fills up, otherwise it writes in fixed intervals
+  if (m_queue.size() >= m_queue.capacity() / 2) {
+    m_flusher_cv.notify_one();
+  }
+}
+
+/**
+ * Body of the flusher thread
+ *
+ * Writes all queued messages at once every few milliseconds, so that frequent log messages cost a single write.
+ */
+void logger::run_flusher() const {
+  std::unique_lock<std::mutex> guard(m_flusher_mutex);
+
+  while (!m_stopped) {
+    m_flusher_cv.wait_for(guard, 50ms);
+    guard.unlock();
+    drain();
+    guard.lock();
+  }
+}
+
+/**
+ * Write all queued messages in a single batch
+ */
+void logger::drain() const {
+  std::lock_guard<std::mutex> guard(m_write_mutex);
+
+  string batch;
+  string message;
+
+  size_t dropped = m_dropped.exchange(0);
+  if (dropped > 0) {
+    batch += m_prefixes.at(loglevel::WARNING) + "logger: Dropped " + to_string(dropped) +
+             " messages, the log queue was full" + m_suffixes.at(loglevel::WARNING) + "\n";
+  }
+
+  while (m_queue.pop(message)) {
+    batch += message;
+  }
+
+  write_all(batch);
+}
+
+/**
+ * Write the data to the output channel, retrying partial writes
+ */
+void logger::write_all(const string& data) const {
+  size_t written = 0;
+
+  while (written < data.size()) {
+    ssize_t bytes = ::write(m_fd, data.data() + written, data.size() - written);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    } else if (bytes <= 0) {
+      return;
+    }
+    written += bytes;
+  }
+}
+
 /**
  * Convert given loglevel name to its enum type counterpart
  */
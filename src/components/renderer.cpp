@@ -1,12 +1,17 @@
 #include "components/renderer.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 
 #include "cairo/context.hpp"
 #include "components/config.hpp"
+#include "components/startup_profiler.hpp"
 #include "events/signal.hpp"
 #include "events/signal_emitter.hpp"
 #include "events/signal_receiver.hpp"
+#include "utils/concurrency.hpp"
 #include "utils/math.hpp"
 #include "utils/units.hpp"
 #include "x11/atoms.hpp"
@@ -14,10 +19,29 @@
 #include "x11/connection.hpp"
 #include "x11/winspec.hpp"
 
+#if WITH_XSHM
+#include "x11/shm.hpp"
+#endif
+#if WITH_XPRESENT
+#include "x11/present.hpp"
+#endif
+
 POLYBAR_NS
 
 static constexpr double BLOCK_GAP{20.0};
 
+/**
+ * Smallest area of whole pixels that contains the given rectangle
+ */
+static xcb_rectangle_t pixel_area(double x, double y, double w, double h) {
+  auto x0 = static_cast<int>(std::floor(x));
+  auto y0 = static_cast<int>(std::floor(y));
+  auto x1 = static_cast<int>(std::ceil(x + w));
+  auto y1 = static_cast<int>(std::ceil(y + h));
+  return {static_cast<int16_t>(x0), static_cast<int16_t>(y0), static_cast<uint16_t>(std::max(x1 - x0, 0)),
+      static_cast<uint16_t>(std::max(y1 - y0, 0))};
+}
+
 /**
  * Create instance
  */
@@ -82,12 +106,6 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
     << cw_flush(true);
   // clang-format on
 
-  m_log.trace("renderer: Allocate window pixmaps");
-  {
-    m_pixmap = m_connection.generate_id();
-    m_connection.create_pixmap(m_depth, m_pixmap, m_window, m_bar.size.w, m_bar.size.h);
-  }
-
   m_log.trace("renderer: Allocate graphic contexts");
   {
     uint32_t mask{0};
@@ -97,30 +115,80 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
     XCB_AUX_ADD_PARAM(&mask, &params, graphics_exposures, 0);
     connection::pack_values(mask, &params, value_list);
     m_gcontext = m_connection.generate_id();
-    m_connection.create_gc(m_gcontext, m_pixmap, mask, value_list.data());
+    m_connection.create_gc(m_gcontext, m_window, mask, value_list.data());
   }
 
   m_log.trace("renderer: Allocate alignment blocks");
   {
-    m_blocks.emplace(alignment::LEFT, alignment_block{nullptr, 0.0, 0.0, 0.});
-    m_blocks.emplace(alignment::CENTER, alignment_block{nullptr, 0.0, 0.0, 0.});
-    m_blocks.emplace(alignment::RIGHT, alignment_block{nullptr, 0.0, 0.0, 0.});
+    m_blocks.emplace(alignment::LEFT, alignment_block{{}, 0.0, 0.0, 0.});
+    m_blocks.emplace(alignment::CENTER, alignment_block{{}, 0.0, 0.0, 0.});
+    m_blocks.emplace(alignment::RIGHT, alignment_block{{}, 0.0, 0.0, 0.});
+  }
+
+#if WITH_XPRESENT
+  if (m_conf.get("settings", "vsync", false)) {
+    m_present = present_window::make(m_connection, m_log, m_window);
   }
+#endif
 
   m_log.trace("renderer: Allocate cairo components");
   {
-    m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, m_visual, m_bar.size.w, m_bar.size.h);
+#if WITH_XSHM
+    // Rendering on the client side avoids sending every drawing operation to the X server
+    if (m_conf.get("settings", "shm-rendering", true)) {
+      m_shm = shm_image::make(m_connection, m_log, m_visual, m_depth, m_bar.size.w, m_bar.size.h);
+    }
+
+    if (m_shm) {
+      m_log.info("renderer: Rendering into shared memory");
+      auto format = m_depth == 32 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+      m_surface =
+          make_unique<cairo::image_surface>(m_shm->data(), format, m_bar.size.w, m_bar.size.h, m_shm->stride());
+    }
+#endif
+
+    bool use_pixmap = !m_surface;
+#if WITH_XPRESENT
+    // Synchronized frames are always shown from the pixmap
+    use_pixmap = use_pixmap || m_present;
+#endif
+
+    if (use_pixmap) {
+      m_log.trace("renderer: Allocate window pixmap");
+      m_pixmap = m_connection.generate_id();
+      m_connection.create_pixmap(m_depth, m_pixmap, m_window, m_bar.size.w, m_bar.size.h);
+    }
+
+    if (!m_surface) {
+      m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, m_visual, m_bar.size.w, m_bar.size.h);
+    }
+
     m_context = make_unique<cairo::context>(*m_surface, m_log);
+
+    if (m_conf.get("settings", "parallel-rendering", false)) {
+      size_t threads = std::min<size_t>(m_blocks.size(), std::max(std::thread::hardware_concurrency(), 1U));
+      m_log.info("renderer: Drawing alignment blocks on %zu threads", threads);
+      m_workers = make_unique<concurrency_util::worker_pool>(threads);
+
+      for (auto&& b : m_blocks) {
+        auto& layer = m_layers[b.first];
+        layer.surface = make_unique<cairo::image_surface>(CAIRO_FORMAT_ARGB32, m_bar.size.w, m_bar.size.h);
+        layer.context = make_unique<cairo::context>(*layer.surface, m_log);
+      }
+    }
   }
 
   m_log.trace("renderer: Load fonts");
   {
+    auto timer = startup_profiler::make().start("Load fonts");
     auto fonts = m_conf.get_list<string>(m_conf.section(), "font", {});
     if (fonts.empty()) {
       m_log.warn("No fonts specified, using fallback font \"fixed\"");
       fonts.emplace_back("fixed");
     }
 
+    vector<string> patterns;
+    vector<int> offsets;
     for (const auto& f : fonts) {
       int offset{0};
       string pattern{f};
@@ -129,9 +197,45 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
         offset = std::strtol(pattern.substr(pos + 1).c_str(), nullptr, 10);
         pattern.erase(pos);
       }
-      auto font = cairo::make_font(*m_context, string{pattern}, offset, m_bar.dpi_x, m_bar.dpi_y);
-      m_log.notice("Loaded font \"%s\" (name=%s, offset=%i, file=%s)", pattern, font->name(), offset, font->file());
-      *m_context << move(font);
+      patterns.emplace_back(move(pattern));
+      offsets.emplace_back(offset);
+    }
+
+    /*
+     * Matching the patterns against the installed fonts is the expensive part and doesn't depend on the cairo context,
+     * so it is done in parallel. The fonts themselves are created here, in the configured order.
+     */
+    vector<FcPattern*> matches(patterns.size(), nullptr);
+    try {
+      concurrency_util::parallel_for(patterns.size(), [&](size_t i) {
+        auto timer = startup_profiler::make().start("Match font \"" + patterns[i] + "\"");
+        matches[i] = cairo::match_font(patterns[i]);
+      });
+    } catch (...) {
+      for (auto* match : matches) {
+        if (match != nullptr) {
+          FcPatternDestroy(match);
+        }
+      }
+      throw;
+    }
+
+    try {
+      for (size_t i = 0; i < patterns.size(); i++) {
+        auto font = cairo::make_font(*m_context, matches[i], offsets[i], m_bar.dpi_x, m_bar.dpi_y);
+        // The font owns the match now
+        matches[i] = nullptr;
+        m_log.notice(
+            "Loaded font \"%s\" (name=%s, offset=%i, file=%s)", patterns[i], font->name(), offsets[i], font->file());
+        *m_context << move(font);
+      }
+    } catch (...) {
+      for (auto* match : matches) {
+        if (match != nullptr) {
+          FcPatternDestroy(match);
+        }
+      }
+      throw;
     }
   }
 
@@ -155,6 +259,7 @@ renderer::renderer(connection& conn, signal_emitter& sig, const config& conf, co
  */
 renderer::~renderer() {
   m_sig.detach(this);
+  free_base_layer();
 }
 
 /**
@@ -184,46 +289,47 @@ int renderer::depth() const {
 void renderer::begin(xcb_rectangle_t rect) {
   m_log.trace_x("renderer: begin (geom=%ix%i+%i+%i)", rect.width, rect.height, rect.x, rect.y);
 
+  if (rect.x != m_rect.x || rect.y != m_rect.y || rect.width != m_rect.width || rect.height != m_rect.height) {
+    m_full_damage = true;
+  }
+
+#if WITH_XSHM
+  // The bar only starts a frame once the server finished reading the previous one (see busy())
+  if (m_shm && m_shm->pending()) {
+    m_log.warn("renderer: Frame started while the X server still reads the previous one");
+    m_shm->wait();
+  }
+#endif
+
   // Reset state
   m_rect = rect;
   m_align = alignment::NONE;
 
-  // Clear canvas
+  for (auto&& b : m_blocks) {
+    b.second.elements.clear();
+    b.second.x = 0.0;
+    b.second.y = 0.0;
+    b.second.width = 0.0;
+  }
+
   m_context->save();
-  m_context->clear();
 
-  // when pseudo-transparency is requested, render the bar into a new layer
-  // that will later be composited against the desktop background
+  // when pseudo-transparency is requested, start from the cached base layer,
+  // the alignment blocks are drawn onto it in renderer::end
   if (m_pseudo_transparency) {
-    m_context->push();
-  }
-
-  // Create corner mask
-  if (m_bar.radius && m_cornermask == nullptr) {
+    update_base_layer();
     m_context->save();
-    m_context->push();
-    // clang-format off
-    *m_context << cairo::rounded_corners{
-        static_cast<double>(m_rect.x),
-        static_cast<double>(m_rect.y),
-        static_cast<double>(m_rect.width),
-        static_cast<double>(m_rect.height), m_bar.radius};
-    // clang-format on
-    *m_context << rgba{0xffffffff};
-    m_context->fill();
-    m_context->pop(&m_cornermask);
+    *m_context << CAIRO_OPERATOR_SOURCE << m_base;
+    m_context->paint();
     m_context->restore();
+    clip_inner_area();
+  } else {
+    // Clear canvas
+    m_context->clear();
+    fill_borders();
+    clip_inner_area();
+    fill_background(*m_context);
   }
-
-  fill_borders();
-
-  // clang-format off
-  m_context->clip(cairo::rect{
-      static_cast<double>(m_rect.x),
-      static_cast<double>(m_rect.y),
-      static_cast<double>(m_rect.width),
-      static_cast<double>(m_rect.height)});
-  // clang-format on
 }
 
 /**
@@ -232,100 +338,159 @@ void renderer::begin(xcb_rectangle_t rect) {
 void renderer::end() {
   m_log.trace_x("renderer: end");
 
-  if (m_align != alignment::NONE) {
-    m_log.trace_x("renderer: pop(%i)", static_cast<int>(m_align));
-    m_context->pop(&m_blocks[m_align].pattern);
-
-    // Capture the concatenated block contents
-    // so that it can be masked with the corner pattern
-    m_context->push();
-
-    // Draw the background on the new layer to make up for
-    // the areas not covered by the alignment blocks
-    fill_background();
-
-    for (auto&& b : m_blocks) {
-      flush(b.first);
-    }
-
-    cairo_pattern_t* blockcontents{};
-    m_context->pop(&blockcontents);
+  auto start = std::chrono::steady_clock::now();
 
-    if (m_cornermask != nullptr) {
-      *m_context << blockcontents;
-      m_context->mask(m_cornermask);
-    } else {
-      *m_context << blockcontents;
-      m_context->paint();
+  // All blocks are measured now, so their contents can be drawn at their final position
+  vector<alignment> blocks;
+  for (auto&& b : m_blocks) {
+    if (!b.second.elements.empty()) {
+      blocks.push_back(b.first);
     }
-
-    m_context->destroy(&blockcontents);
-  } else {
-    fill_background();
   }
 
-  // For pseudo-transparency, capture the contents of the rendered bar and
-  // composite it against the desktop wallpaper. This way transparent parts of
-  // the bar will be filled by the wallpaper creating illusion of transparency.
-  if (m_pseudo_transparency) {
-    cairo_pattern_t* barcontents{};
-    m_context->pop(&barcontents); // corresponding push is in renderer::begin
+  if (m_workers) {
+    m_workers->run(blocks.size(), [&](size_t i) { draw_layer(blocks[i]); });
+  }
 
-    auto root_bg = m_background->get_surface();
-    if (root_bg != nullptr) {
-      m_log.trace_x("renderer: root background");
-      *m_context << *root_bg;
-      m_context->paint();
-      *m_context << CAIRO_OPERATOR_OVER;
-    }
-    *m_context << barcontents;
-    m_context->paint();
-    m_context->destroy(&barcontents);
+  for (auto a : blocks) {
+    paint_block(a);
   }
 
+  m_log.trace("renderer: Painted %zu alignment blocks in %lld us", blocks.size(),
+      static_cast<long long>(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+
   m_context->restore();
-  m_surface->flush();
 
-  flush();
+  // Whatever the blocks of the previous render covered now shows the background again
+  for (const auto& area : m_prev_block_areas) {
+    add_damage(area);
+  }
+  std::swap(m_block_areas, m_prev_block_areas);
+  m_block_areas.clear();
+
+  present();
 
   m_sig.emit(signals::ui::changed{});
 }
 
 /**
- * Flush contents of given alignment block
+ * Get the area covered by the given alignment block, rounded to whole pixels
  */
-void renderer::flush(alignment a) {
-  if (m_blocks[a].pattern == nullptr) {
-    return;
-  }
-
-  m_context->save();
-
+cairo::rect renderer::block_area(alignment a) const {
   double x = static_cast<int>(block_x(a) + 0.5);
   double y = static_cast<int>(block_y(a) + 0.5);
   double w = static_cast<int>(block_w(a) + 0.5);
   double h = static_cast<int>(block_h(a) + 0.5);
+  return cairo::rect{m_rect.x + x, m_rect.y + y, w, h};
+}
+
+/**
+ * Draw the recorded elements of the given alignment block onto the context
+ *
+ * The area of the block must already show the bar background.
+ *
+ * @param x Absolute x position of the block
+ * @param layer Whether the context belongs to a block layer
+ */
+void renderer::draw_elements(cairo::context& ctxt, alignment a, double x, bool layer) {
+  for (const auto& element : m_blocks.at(a).elements) {
+    double element_x = x + element.x;
+
+    if (element.has_bg) {
+      fill_area(ctxt, element.bg,
+          cairo::rect{element_x, static_cast<double>(m_rect.y), element.width, static_cast<double>(m_rect.height)},
+          layer);
+    }
+
+    if (!element.runs.empty()) {
+      ctxt.save();
+      ctxt << cairo::abspos{element_x, m_rect.y + m_rect.height / 2.0};
+      ctxt << m_comp_fg;
+      ctxt << element.fg;
+      for (const auto& run : element.runs) {
+        ctxt << run;
+      }
+      ctxt.restore();
+    }
+
+    if (element.has_ul) {
+      fill_underline(ctxt, element.ul, element_x, element.width);
+    }
+
+    if (element.has_ol) {
+      fill_overline(ctxt, element.ol, element_x, element.width);
+    }
+  }
+
+  ctxt << cairo::abspos{0.0, 0.0};
+}
+
+/**
+ * Draw the given alignment block onto its layer
+ *
+ * Called on the worker threads, only the layer of the block is modified.
+ */
+void renderer::draw_layer(alignment a) {
+  auto area = block_area(a);
+  auto& ctxt = *m_layers.at(a).context;
+
+  ctxt.save();
+  ctxt.clip(area);
+  ctxt.clear();
+  fill_background(ctxt);
+  draw_elements(ctxt, a, area.x, true);
+  ctxt.restore();
+}
+
+/**
+ * Draw the given alignment block onto the bar
+ *
+ * If blocks are drawn in parallel, the already drawn layer of the block is composited instead.
+ */
+void renderer::paint_block(alignment a) {
+  auto area = block_area(a);
+  double x = area.x - m_rect.x;
+  double y = area.y - m_rect.y;
+  double w = area.w;
+  double h = area.h;
   double xw = x + w;
   bool fits{xw <= m_rect.width};
 
-  m_log.trace("renderer: flush(%i geom=%gx%g+%g+%g, falloff=%i)", static_cast<int>(a), w, h, x, y, !fits);
+  m_log.trace("renderer: paint_block(%i geom=%gx%g+%g+%g, falloff=%i)", static_cast<int>(a), w, h, x, y, !fits);
 
-  // Set block shape
-  *m_context << cairo::abspos{0.0, 0.0};
-  *m_context << cairo::rect{m_rect.x + x, m_rect.y + y, w, h};
+  m_block_areas.push_back(pixel_area(area.x, area.y, w, h));
+  add_damage(m_block_areas.back());
 
-  // Restrict drawing to the block rectangle
-  m_context->clip(true);
+  m_context->save();
 
-  // Clear the area covered by the block
-  m_context->clear();
+  // Restrict drawing to the block rectangle
+  m_context->clip(area);
 
-  *m_context << cairo::translate{x, 0.0};
-  *m_context << m_blocks[a].pattern;
-  m_context->paint();
+  if (m_workers) {
+    if (m_pseudo_transparency) {
+      // The layer already contains the bar background, it goes directly on top of the desktop background
+      *m_context << CAIRO_OPERATOR_SOURCE << m_underlay;
+      m_context->paint();
+      *m_context << CAIRO_OPERATOR_OVER;
+    } else {
+      *m_context << CAIRO_OPERATOR_SOURCE;
+    }
+    *m_context << *m_layers.at(a).surface;
+    m_context->paint();
+  } else {
+    // Blocks may overlap, the block hides what was drawn below it, the same as a layer does
+    if (m_pseudo_transparency) {
+      // The base layer is the bar background on top of the desktop background
+      *m_context << CAIRO_OPERATOR_SOURCE << m_base;
+      m_context->paint();
+    } else {
+      m_context->clear();
+      fill_background(*m_context);
+    }
+    draw_elements(*m_context, a, area.x, false);
+  }
 
-  *m_context << cairo::abspos{0.0, 0.0};
-  m_context->destroy(&m_blocks[a].pattern);
   m_context->restore();
 
   if (!fits) {
@@ -356,17 +521,68 @@ void renderer::flush(alignment a) {
 }
 
 /**
- * Flush pixmap contents onto the target window
+ * Copy the whole bar onto the target window
+ *
+ * While a frame is in flight, the whole bar is copied with the next frame instead.
  */
 void renderer::flush() {
-  m_log.trace_x("renderer: flush");
+  m_full_damage = true;
+  if (!busy()) {
+    present();
+  }
+}
+
+/**
+ * Copy the area drawn since the last call onto the target window
+ */
+void renderer::present() {
+  m_log.trace_x("renderer: present");
 
   highlight_clickable_areas();
+#ifdef DEBUG_HINTS
+  m_full_damage = true;
+#endif
 
   m_surface->flush();
-  // Copy pixmap onto the window
-  m_connection.copy_area(m_pixmap, m_window, m_gcontext, 0, 0, 0, 0, m_bar.size.w, m_bar.size.h);
-  m_connection.flush();
+
+  xcb_rectangle_t area{0, 0, static_cast<uint16_t>(m_bar.size.w), static_cast<uint16_t>(m_bar.size.h)};
+  if (!m_full_damage) {
+    // Only keep the part of the damage that lies within the window
+    int16_t x0 = std::max<int16_t>(m_damage.x, 0);
+    int16_t y0 = std::max<int16_t>(m_damage.y, 0);
+    int x1 = std::min<int>(m_damage.x + m_damage.width, area.width);
+    int y1 = std::min<int>(m_damage.y + m_damage.height, area.height);
+    area = {x0, y0, static_cast<uint16_t>(std::max(x1 - x0, 0)), static_cast<uint16_t>(std::max(y1 - y0, 0))};
+  }
+
+  m_full_damage = false;
+  m_damage = {0, 0, 0U, 0U};
+
+  if (area.width > 0 && area.height > 0) {
+    m_log.trace_x("renderer: present(geom=%ix%i+%i+%i)", area.width, area.height, area.x, area.y);
+    bool shown{false};
+
+#if WITH_XSHM
+    if (m_shm) {
+      // If there is a pixmap, the frame is shown from there
+      m_shm->put(m_pixmap != XCB_NONE ? m_pixmap : m_window, m_gcontext, area);
+      shown = m_pixmap == XCB_NONE;
+    }
+#endif
+#if WITH_XPRESENT
+    if (m_present) {
+      m_present->present(m_pixmap);
+      shown = true;
+    }
+#endif
+
+    if (!shown) {
+      // Copy pixmap onto the window
+      m_connection.copy_area(
+          m_pixmap, m_window, m_gcontext, area.x, area.y, area.x, area.y, area.width, area.height);
+    }
+    m_connection.flush();
+  }
 
   if (!m_snapshot_dst.empty()) {
     try {
@@ -379,6 +595,25 @@ void renderer::flush() {
   }
 }
 
+/**
+ * Extend the area that is copied onto the window during the next present()
+ */
+void renderer::add_damage(const xcb_rectangle_t& area) {
+  if (area.width == 0 || area.height == 0) {
+    return;
+  } else if (m_damage.width == 0 || m_damage.height == 0) {
+    m_damage = area;
+    return;
+  }
+
+  int x0 = std::min(m_damage.x, area.x);
+  int y0 = std::min(m_damage.y, area.y);
+  int x1 = std::max(m_damage.x + m_damage.width, area.x + area.width);
+  int y1 = std::max(m_damage.y + m_damage.height, area.y + area.height);
+  m_damage = {static_cast<int16_t>(x0), static_cast<int16_t>(y0), static_cast<uint16_t>(x1 - x0),
+      static_cast<uint16_t>(y1 - y0)};
+}
+
 /**
  * Get x position of block for given alignment
  *
@@ -495,50 +730,152 @@ void renderer::increase_x(double dx) {
 /**
  * Fill background color
  */
-void renderer::fill_background() {
-  m_context->save();
-  *m_context << m_comp_bg;
+void renderer::fill_background(cairo::context& ctxt) {
+  ctxt.save();
+  ctxt << m_comp_bg;
 
   if (!m_bar.background_steps.empty()) {
     m_log.trace_x("renderer: gradient background (steps=%lu)", m_bar.background_steps.size());
-    *m_context << cairo::linear_gradient{0.0, 0.0 + m_rect.y, 0.0, 0.0 + m_rect.height, m_bar.background_steps};
+    ctxt << cairo::linear_gradient{0.0, 0.0 + m_rect.y, 0.0, 0.0 + m_rect.height, m_bar.background_steps};
   } else {
     m_log.trace_x("renderer: solid background #%08x", m_bar.background);
-    *m_context << m_bar.background;
+    ctxt << m_bar.background;
   }
 
+  ctxt.paint();
+  ctxt.restore();
+}
+
+/**
+ * Fill the area with a background color
+ *
+ * With pseudo-transparency, a background that replaces the bar background is drawn over the desktop background
+ * instead, the same as the bar background itself. On a block layer, this happens when the layer is composited.
+ */
+void renderer::fill_area(cairo::context& ctxt, rgba color, const cairo::rect& area, bool layer) {
+  ctxt.save();
+  ctxt.clip(area);
+
+  if (m_pseudo_transparency && !layer && m_comp_bg == CAIRO_OPERATOR_SOURCE) {
+    ctxt << CAIRO_OPERATOR_SOURCE << m_underlay;
+    ctxt.paint();
+    ctxt << CAIRO_OPERATOR_OVER;
+  } else {
+    ctxt << m_comp_bg;
+  }
+
+  ctxt << color;
+  ctxt.paint();
+  ctxt.restore();
+}
+
+/**
+ * Restrict drawing to the inner area of the bar, with rounded corners if configured
+ */
+void renderer::clip_inner_area() {
+  if (m_bar.radius) {
+    // clang-format off
+    *m_context << cairo::rounded_corners{
+        static_cast<double>(m_rect.x),
+        static_cast<double>(m_rect.y),
+        static_cast<double>(m_rect.width),
+        static_cast<double>(m_rect.height), m_bar.radius};
+    // clang-format on
+    m_context->clip();
+  } else {
+    // clang-format off
+    m_context->clip(cairo::rect{
+        static_cast<double>(m_rect.x),
+        static_cast<double>(m_rect.y),
+        static_cast<double>(m_rect.width),
+        static_cast<double>(m_rect.height)});
+    // clang-format on
+  }
+}
+
+/**
+ * Rebuild the pseudo-transparency layers if they are missing or the bar geometry changed
+ */
+void renderer::update_base_layer() {
+  if (m_base != nullptr && m_base_rect.x == m_rect.x && m_base_rect.y == m_rect.y &&
+      m_base_rect.width == m_rect.width && m_base_rect.height == m_rect.height) {
+    return;
+  }
+
+  m_log.trace("renderer: Rebuild pseudo-transparency base layer");
+  free_base_layer();
+  m_base_rect = m_rect;
+
+  m_context->save();
+
+  // Desktop background and borders
+  m_context->push();
+  auto root_bg = m_background->get_surface();
+  if (root_bg != nullptr) {
+    m_log.trace_x("renderer: root background");
+    *m_context << *root_bg;
+    m_context->paint();
+    *m_context << CAIRO_OPERATOR_OVER;
+  }
+  fill_borders();
+  m_context->pop(&m_underlay);
+
+  // Bar background on top of it, shaped by the corner mask
+  m_context->push();
+  *m_context << m_underlay;
+  m_context->paint();
+
+  m_context->push();
+  fill_background(*m_context);
+  cairo_pattern_t* background{};
+  m_context->pop(&background);
+
+  clip_inner_area();
+  *m_context << CAIRO_OPERATOR_OVER << background;
   m_context->paint();
+  m_context->destroy(&background);
+  m_context->pop(&m_base);
+
   m_context->restore();
 }
 
+void renderer::free_base_layer() {
+  if (m_underlay != nullptr) {
+    m_context->destroy(&m_underlay);
+  }
+  if (m_base != nullptr) {
+    m_context->destroy(&m_base);
+  }
+}
+
 /**
  * Fill overline color
  */
-void renderer::fill_overline(rgba color, double x, double w) {
+void renderer::fill_overline(cairo::context& ctxt, rgba color, double x, double w) {
   if (m_bar.overline.size) {
     m_log.trace_x("renderer: overline(x=%f, w=%f)", x, w);
-    m_context->save();
-    *m_context << m_comp_ol;
-    *m_context << color;
-    *m_context << cairo::rect{x, static_cast<double>(m_rect.y), w, static_cast<double>(m_bar.overline.size)};
-    m_context->fill();
-    m_context->restore();
+    ctxt.save();
+    ctxt << m_comp_ol;
+    ctxt << color;
+    ctxt << cairo::rect{x, static_cast<double>(m_rect.y), w, static_cast<double>(m_bar.overline.size)};
+    ctxt.fill();
+    ctxt.restore();
   }
 }
 
 /**
  * Fill underline color
  */
-void renderer::fill_underline(rgba color, double x, double w) {
+void renderer::fill_underline(cairo::context& ctxt, rgba color, double x, double w) {
   if (m_bar.underline.size) {
     m_log.trace_x("renderer: underline(x=%f, w=%f)", x, w);
-    m_context->save();
-    *m_context << m_comp_ul;
-    *m_context << color;
-    *m_context << cairo::rect{x, static_cast<double>(m_rect.y + m_rect.height - m_bar.underline.size), w,
+    ctxt.save();
+    ctxt << m_comp_ul;
+    ctxt << color;
+    ctxt << cairo::rect{x, static_cast<double>(m_rect.y + m_rect.height - m_bar.underline.size), w,
         static_cast<double>(m_bar.underline.size)};
-    m_context->fill();
-    m_context->restore();
+    ctxt.fill();
+    ctxt.restore();
   }
 }
 
@@ -677,88 +1014,43 @@ void renderer::fill_borders() {
 }
 
 /**
- * Draw text contents
+ * Measure text contents
+ *
+ * The text is only drawn in paint_block, once the position of the block is known.
  */
 void renderer::render_text(const tags::context& ctxt, const string&& contents) {
   assert(ctxt.get_alignment() != alignment::NONE && ctxt.get_alignment() == m_align);
   m_log.trace_x("renderer: text(%s)", contents.c_str());
 
-  cairo::abspos origin{};
-  origin.x = m_rect.x + m_blocks[m_align].x;
-  origin.y = m_rect.y + m_rect.height / 2.0;
-
-  double x_old = m_blocks[m_align].x;
-  /*
-   * This variable is increased by the text renderer
-   */
-  double x_new = x_old;
-
-  cairo::textblock block{};
-  block.align = m_align;
-  block.contents = contents;
-  block.font = ctxt.get_font();
-  block.x_advance = &x_new;
-  block.y_advance = &m_blocks[m_align].y;
-  block.bg_rect = cairo::rect{0.0, 0.0, 0.0, 0.0};
-
-  rgba bg = ctxt.get_bg();
-
-  // Only draw text background if the color differs from
-  // the background color of the bar itself
-  // Note: this means that if the user explicitly set text
-  // background color equal to background-0 it will be ignored
-  if (bg != m_bar.background) {
-    block.bg = bg;
-    block.bg_operator = m_comp_bg;
-    block.bg_rect.x = m_rect.x;
-    block.bg_rect.y = m_rect.y;
-    block.bg_rect.h = m_rect.height;
-  }
+  auto& block = m_blocks[m_align];
 
-  m_context->save();
-  *m_context << origin;
-  *m_context << m_comp_fg;
-  *m_context << ctxt.get_fg();
-  *m_context << block;
-  m_context->restore();
+  block_element element{};
+  element.x = block.x;
+  element.runs = m_context->shape(contents, ctxt.get_font());
 
-  double dx = x_new - x_old;
-  increase_x(dx);
-
-  if (dx > 0.0) {
-    if (ctxt.has_underline()) {
-      fill_underline(ctxt.get_ul(), origin.x, dx);
-    }
-
-    if (ctxt.has_overline()) {
-      fill_overline(ctxt.get_ol(), origin.x, dx);
-    }
-  }
-}
-
-void renderer::draw_offset(const tags::context& ctxt, rgba color, double x, double w) {
-  if (w <= 0) {
-    return;
-  }
-
-  if (color != m_bar.background) {
-    m_log.trace_x("renderer: offset(x=%f, w=%f)", x, w);
-    m_context->save();
-    *m_context << m_comp_bg;
-    *m_context << color;
-    *m_context << cairo::rect{
-        m_rect.x + x, static_cast<double>(m_rect.y), w, static_cast<double>(m_rect.y + m_rect.height)};
-    m_context->fill();
-    m_context->restore();
+  for (const auto& run : element.runs) {
+    element.width += run.x_advance;
+    block.y += run.y_advance;
   }
 
-  if (ctxt.has_underline()) {
-    fill_underline(ctxt.get_ul(), x, w);
+  double dx = element.width;
+  if (dx > 0.0) {
+    element.fg = ctxt.get_fg();
+    element.bg = ctxt.get_bg();
+
+    // Only draw text background if the color differs from
+    // the background color of the bar itself
+    // Note: this means that if the user explicitly set text
+    // background color equal to background-0 it will be ignored
+    element.has_bg = element.bg != m_bar.background;
+    element.ul = ctxt.get_ul();
+    element.has_ul = ctxt.has_underline();
+    element.ol = ctxt.get_ol();
+    element.has_ol = ctxt.has_overline();
+    add_element(move(element));
   }
 
-  if (ctxt.has_overline()) {
-    fill_overline(ctxt.get_ol(), x, w);
-  }
+  increase_x(dx);
 }
 
 void renderer::render_offset(const tags::context& ctxt, const extent_val offset) {
@@ -766,30 +1058,46 @@ void renderer::render_offset(const tags::context& ctxt, const extent_val offset)
   m_log.trace_x("renderer: offset_pixel(%f)", offset);
 
   int offset_width = units_utils::extent_to_pixel(offset, m_bar.dpi_x);
-  rgba bg = ctxt.get_bg();
-  draw_offset(ctxt, bg, m_blocks[m_align].x, offset_width);
+
+  if (offset_width > 0) {
+    block_element element{};
+    element.x = m_blocks[m_align].x;
+    element.width = offset_width;
+    element.bg = ctxt.get_bg();
+    element.has_bg = element.bg != m_bar.background;
+    element.ul = ctxt.get_ul();
+    element.has_ul = ctxt.has_underline();
+    element.ol = ctxt.get_ol();
+    element.has_ol = ctxt.has_overline();
+
+    // Offsets without any color are only spacing
+    if (element.has_bg || element.has_ul || element.has_ol) {
+      add_element(move(element));
+    }
+  }
+
   increase_x(offset_width);
 }
 
+/**
+ * Record an element of the current alignment block
+ */
+void renderer::add_element(block_element&& element) {
+  m_log.trace_x("renderer: element(x=%f, w=%f)", element.x, element.width);
+  m_blocks[m_align].elements.emplace_back(move(element));
+}
+
 void renderer::change_alignment(const tags::context& ctxt) {
   auto align = ctxt.get_alignment();
   assert(align != alignment::NONE);
   if (align != m_align) {
     m_log.trace_x("renderer: change_alignment(%i)", static_cast<int>(align));
 
-    if (m_align != alignment::NONE) {
-      m_log.trace_x("renderer: pop(%i)", static_cast<int>(m_align));
-      m_context->pop(&m_blocks[m_align].pattern);
-    }
-
     m_align = align;
+    m_blocks[m_align].elements.clear();
     m_blocks[m_align].x = 0.0;
     m_blocks[m_align].y = 0.0;
     m_blocks[m_align].width = 0.;
-    m_context->push();
-    m_log.trace_x("renderer: push(%i)", static_cast<int>(m_align));
-
-    fill_background();
   }
 }
 
@@ -826,15 +1134,70 @@ void renderer::highlight_clickable_areas() {
 }
 
 bool renderer::on(const signals::ui::request_snapshot& evt) {
-  m_snapshot_dst = evt.cast();
+  auto [window, dst] = evt.cast();
+  if (window != m_bar.x_data.window) {
+    return false;
+  }
+  m_snapshot_dst = move(dst);
   return true;
 }
 
+/**
+ * The desktop background or the bar position changed, the base layer is
+ * rebuilt during the next render.
+ */
+bool renderer::on(const signals::ui::update_background&) {
+  free_base_layer();
+  m_full_damage = true;
+  return false;
+}
+
+bool renderer::on([[maybe_unused]] const signals::ui::x_generic_event& evt) {
+  bool handled{false};
+#if WITH_XSHM
+  handled = m_shm && m_shm->handle(evt.cast());
+#endif
+#if WITH_XPRESENT
+  handled = handled || (m_present && m_present->handle(evt.cast()));
+#endif
+
+  if (handled && m_frame_presented && !busy()) {
+    m_frame_presented();
+  }
+  return handled;
+}
+
+bool renderer::busy() {
+  bool busy{false};
+#if WITH_XSHM
+  busy = m_shm && m_shm->pending();
+#endif
+#if WITH_XPRESENT
+  busy = (m_present && m_present->pending()) || busy;
+#endif
+  return busy;
+}
+
+std::chrono::milliseconds renderer::frame_timeout() const {
+  std::chrono::milliseconds timeout{0};
+#if WITH_XSHM
+  timeout = std::max(timeout, shm_image::PUT_TIMEOUT);
+#endif
+#if WITH_XPRESENT
+  timeout = std::max(timeout, present_window::FRAME_TIMEOUT);
+#endif
+  return timeout;
+}
+
+void renderer::on_frame_presented(std::function<void()>&& callback) {
+  m_frame_presented = move(callback);
+}
+
 void renderer::apply_tray_position(const tags::context& context) {
   auto [alignment, pos] = context.get_relative_tray_position();
   if (alignment != alignment::NONE) {
     int absolute_x = static_cast<int>(block_x(alignment) + pos);
-    m_sig.emit(signals::ui_tray::tray_pos_change{absolute_x});
+    m_sig.emit(signals::ui_tray::tray_pos_change{{m_bar.x_data.window, absolute_x}});
   }
 }
 
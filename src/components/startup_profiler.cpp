@@ -0,0 +1,74 @@
+#include "components/startup_profiler.hpp"
+
+#include <algorithm>
+
+#include "components/logger.hpp"
+#include "utils/concurrency.hpp"
+#include "utils/factory.hpp"
+
+POLYBAR_NS
+
+/**
+ * Create instance
+ */
+startup_profiler::make_type startup_profiler::make() {
+  return *factory_util::singleton<startup_profiler>();
+}
+
+startup_profiler::timer::timer(startup_profiler& profiler, string&& name)
+    : m_profiler(profiler), m_name(move(name)), m_start(time_util::clock_t::now()) {}
+
+startup_profiler::timer::~timer() {
+  m_profiler.record(move(m_name), m_start, time_util::clock_t::now());
+}
+
+startup_profiler::startup_profiler() : m_begin(time_util::clock_t::now()) {}
+
+/**
+ * Enable profiling, phases are measured relative to this point in time
+ */
+void startup_profiler::enable() {
+  m_begin = time_util::clock_t::now();
+  m_enabled = true;
+}
+
+bool startup_profiler::enabled() const {
+  return m_enabled;
+}
+
+unique_ptr<startup_profiler::timer> startup_profiler::start(string&& name) {
+  if (!m_enabled || m_reported) {
+    return nullptr;
+  }
+  return make_unique<timer>(*this, move(name));
+}
+
+void startup_profiler::report(const logger& log) {
+  vector<entry> entries;
+
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_enabled || m_reported.exchange(true)) {
+      return;
+    }
+    entries = m_entries;
+  }
+
+  std::stable_sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return a.start < b.start; });
+
+  auto ms = [](time_util::clock_t::duration d) { return chrono::duration<double, std::milli>(d).count(); };
+
+  log.notice("Startup profile (start, duration, thread, phase):");
+  for (const auto& e : entries) {
+    log.notice("  %8.2f ms %8.2f ms  [%zu] %s", ms(e.start - m_begin), ms(e.end - e.start), e.thread, e.name);
+  }
+  log.notice("Startup took %.2f ms", ms(time_util::clock_t::now() - m_begin));
+}
+
+void startup_profiler::record(
+    string&& name, time_util::clock_t::time_point start, time_util::clock_t::time_point end) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_entries.push_back({move(name), start, end, concurrency_util::thread_id(this_thread::get_id())});
+}
+
+POLYBAR_NS_END
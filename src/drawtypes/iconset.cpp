@@ -1,12 +1,20 @@
 #include "drawtypes/iconset.hpp"
 
 #include <algorithm>
+#include <queue>
 
 POLYBAR_NS
 
 namespace drawtypes {
+  /**
+   * Maximum number of memoized fuzzy lookups, the cache is cleared once it grows larger.
+   */
+  static constexpr size_t MAX_FUZZY_MATCHES{256};
+
   void iconset::add(string id, label_t&& icon) {
     m_icons.emplace(id, forward<decltype(icon)>(icon));
+    m_index_valid = false;
+    m_fuzzy_matches.clear();
   }
 
   bool iconset::has(const string& id) {
@@ -22,21 +30,19 @@ namespace drawtypes {
 
     // If fuzzy matching is turned on, try that first before returning the fallback.
     if (fuzzy_match) {
-      // works by finding the *longest* matching icon to the given workspace id
-      size_t max_size = -1;
-      label_t max_label;
-
-      for (auto const& icon : m_icons) {
-        if (id.find(icon.first) != std::string::npos) {
-          if (icon.first.length() > max_size || !max_label) {
-            max_size = icon.first.length();
-            max_label = icon.second;
-          }
+      auto cached = m_fuzzy_matches.find(id);
+
+      if (cached == m_fuzzy_matches.end()) {
+        if (m_fuzzy_matches.size() >= MAX_FUZZY_MATCHES) {
+          m_fuzzy_matches.clear();
         }
+
+        const icon_entry* match = find_longest_match(id);
+        cached = m_fuzzy_matches.emplace(id, match ? match->second : nullptr).first;
       }
 
-      if (max_label) {
-        return max_label;
+      if (cached->second) {
+        return cached->second;
       }
     }
 
@@ -46,6 +52,94 @@ namespace drawtypes {
   iconset::operator bool() {
     return !m_icons.empty();
   }
+
+  /**
+   * Builds the Aho-Corasick automaton over all icon ids
+   */
+  void iconset::build_index() {
+    m_index.clear();
+    m_index.emplace_back();
+
+    for (const auto& icon : m_icons) {
+      size_t node = 0;
+
+      for (char c : icon.first) {
+        auto child = m_index[node].children.find(c);
+        if (child == m_index[node].children.end()) {
+          m_index.emplace_back();
+          child = m_index[node].children.emplace(c, m_index.size() - 1).first;
+        }
+        node = child->second;
+      }
+
+      m_index[node].match = &icon;
+    }
+
+    // Set the failure links in breadth-first order so that the links of all shorter nodes are already known
+    std::queue<size_t> queue;
+    for (const auto& child : m_index[0].children) {
+      m_index[child.second].fail = 0;
+      queue.push(child.second);
+    }
+
+    while (!queue.empty()) {
+      size_t node = queue.front();
+      queue.pop();
+
+      // A node's own id is longer than any id ending at its failure node
+      if (!m_index[node].match) {
+        m_index[node].match = m_index[m_index[node].fail].match;
+      }
+
+      for (const auto& child : m_index[node].children) {
+        size_t fail = m_index[node].fail;
+        while (fail != 0 && m_index[fail].children.count(child.first) == 0) {
+          fail = m_index[fail].fail;
+        }
+
+        auto target = m_index[fail].children.find(child.first);
+        m_index[child.second].fail = target == m_index[fail].children.end() ? 0 : target->second;
+
+        queue.push(child.second);
+      }
+    }
+
+    m_index_valid = true;
+  }
+
+  /**
+   * Finds the longest icon id that is contained in the given id in a single pass over the id
+   *
+   * If multiple ids of the same length match, the lexicographically smallest one is used.
+   *
+   * @returns nullptr if no icon id is contained in the id
+   */
+  const iconset::icon_entry* iconset::find_longest_match(const string& id) {
+    if (!m_index_valid) {
+      build_index();
+    }
+
+    size_t node = 0;
+    const icon_entry* best = m_index[0].match;
+
+    for (char c : id) {
+      auto child = m_index[node].children.find(c);
+      while (node != 0 && child == m_index[node].children.end()) {
+        node = m_index[node].fail;
+        child = m_index[node].children.find(c);
+      }
+
+      node = child == m_index[node].children.end() ? 0 : child->second;
+
+      const icon_entry* match = m_index[node].match;
+      if (match && (!best || match->first.size() > best->first.size() ||
+                       (match->first.size() == best->first.size() && match->first < best->first))) {
+        best = match;
+      }
+    }
+
+    return best;
+  }
 } // namespace drawtypes
 
 POLYBAR_NS_END
@@ -8,15 +8,58 @@
 POLYBAR_NS
 
 namespace drawtypes {
+  /**
+   * Splits the text into literal text and slots for the given tokens
+   *
+   * The tokens are expected in the order in which they appear in the text, the n-th token belongs to the n-th
+   * occurrence of its token string.
+   */
+  label_template::label_template(const string& text, vector<token>&& tokens)
+      : m_tokens(move(tokens)), m_size(text.size()) {
+    size_t pos = 0;
+
+    for (size_t i = 0; i < m_tokens.size(); i++) {
+      const string& tok = m_tokens[i].token;
+      size_t start = text.find(tok, pos);
+
+      if (start == string::npos) {
+        continue;
+      }
+
+      if (start > pos) {
+        m_segments.push_back({text.substr(pos, start - pos), -1});
+      }
+
+      m_segments.push_back({tok, static_cast<int>(i)});
+      pos = start + tok.size();
+    }
+
+    if (pos < text.size()) {
+      m_segments.push_back({text.substr(pos), -1});
+    }
+  }
+
+  const vector<label_template::segment>& label_template::segments() const {
+    return m_segments;
+  }
+
+  const vector<token>& label_template::tokens() const {
+    return m_tokens;
+  }
+
+  size_t label_template::size() const {
+    return m_size;
+  }
+
   /**
    * Gets the text from the label as it should be rendered
    *
    * Here tokens are replaced with values and minlen and maxlen properties are applied
    */
   string label::get() const {
-    const size_t len = string_util::char_len(m_tokenized);
+    string text = this->text();
+    const size_t len = string_util::char_len(text);
     if (len >= m_minlen) {
-      string text = m_tokenized;
       if (m_maxlen > 0 && len > m_maxlen) {
         if (m_ellipsis) {
           text = string_util::utf8_truncate(std::move(text), m_maxlen - 3) + "...";
@@ -42,64 +85,148 @@ namespace drawtypes {
         --left_fill_len;
       }
     }
-    return string(left_fill_len, ' ') + m_tokenized + string(right_fill_len, ' ');
+
+    text.insert(0_z, left_fill_len, ' ');
+    text.append(right_fill_len, ' ');
+    return text;
   }
 
-  label::operator bool() {
-    return !m_tokenized.empty();
+  label::operator bool() const {
+    if (m_cleared) {
+      return false;
+    }
+
+    for (const auto& segment : m_template->segments()) {
+      if (segment.slot == -1 || !m_values[segment.slot].set) {
+        if (!segment.text.empty()) {
+          return true;
+        }
+      } else if (!m_values[segment.slot].value.empty()) {
+        return true;
+      }
+    }
+
+    return false;
   }
 
+  /**
+   * Creates a copy of this label without any token values
+   *
+   * The clone shares the compiled template with this label.
+   */
   label_t label::clone() {
-    vector<token> tokens;
-    if (!m_tokens.empty()) {
-      std::back_insert_iterator<decltype(tokens)> back_it(tokens);
-      std::copy(m_tokens.begin(), m_tokens.end(), back_it);
-    }
-    return std::make_shared<label>(m_text, m_foreground, m_background, m_underline, m_overline, m_font, m_padding,
-        m_margin, m_minlen, m_maxlen, m_alignment, m_ellipsis, move(tokens));
+    return std::make_shared<label>(m_template, m_foreground, m_background, m_underline, m_overline, m_font, m_padding,
+        m_margin, m_minlen, m_maxlen, m_alignment, m_ellipsis);
   }
 
   void label::clear() {
-    m_tokenized.clear();
+    m_cleared = true;
   }
 
+  /**
+   * Removes all token values
+   *
+   * The strings are kept so that their memory is reused for the next values.
+   */
   void label::reset_tokens() {
-    m_tokenized = m_text;
-  }
-
-  void label::reset_tokens(const string& tokenized) {
-    m_tokenized = tokenized;
+    m_cleared = false;
+    for (auto&& slot : m_values) {
+      slot.set = false;
+    }
   }
 
+  /**
+   * Whether the label contains the given token and it was not replaced yet
+   */
   bool label::has_token(const string& token) const {
-    return m_tokenized.find(token) != string::npos;
+    if (m_cleared) {
+      return false;
+    }
+
+    const auto& tokens = m_template->tokens();
+    for (size_t i = 0; i < tokens.size(); i++) {
+      if (!m_values[i].set && tokens[i].token == token) {
+        return true;
+      }
+    }
+
+    return false;
   }
 
+  /**
+   * Sets the value of all slots for the given token that don't have a value yet
+   *
+   * The min and max lengths of the individual slots are applied here.
+   */
   void label::replace_token(const string& token, string replacement) {
-    if (!has_token(token)) {
+    if (m_cleared) {
       return;
     }
 
-    for (auto&& tok : m_tokens) {
-      string repl{replacement};
-      size_t len = string_util::char_len(repl);
-      if (token == tok.token) {
-        if (tok.max != 0_z && len > tok.max) {
-          repl = string_util::utf8_truncate(std::move(repl), tok.max) + tok.suffix;
-        } else if (tok.min != 0_z && len < tok.min) {
-          if (tok.rpadding) {
-            repl.append(tok.min - len, ' ');
-          } else {
-            repl.insert(0_z, tok.min - len, tok.zpad ? '0' : ' ');
-          }
+    const auto& tokens = m_template->tokens();
+    size_t len = string::npos;
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+      const auto& tok = tokens[i];
+      auto& slot = m_values[i];
+
+      if (slot.set || tok.token != token) {
+        continue;
+      }
+
+      if (len == string::npos) {
+        len = string_util::char_len(replacement);
+      }
+
+      if (tok.max != 0_z && len > tok.max) {
+        slot.value = string_util::utf8_truncate(string{replacement}, tok.max) + tok.suffix;
+      } else if (tok.min != 0_z && len < tok.min) {
+        slot.value = replacement;
+        if (tok.rpadding) {
+          slot.value.append(tok.min - len, ' ');
+        } else {
+          slot.value.insert(0_z, tok.min - len, tok.zpad ? '0' : ' ');
         }
+      } else {
+        slot.value = replacement;
+      }
+
+      slot.set = true;
+    }
+  }
+
+  /**
+   * Assembles the text from the template and the token values
+   */
+  string label::text() const {
+    if (m_cleared) {
+      return {};
+    }
+
+    const auto& segments = m_template->segments();
 
-        /*
-         * Only replace first occurence, so that the proper token objects can be used
-         */
-        m_tokenized = string_util::replace(m_tokenized, token, move(repl));
+    // Labels without tokens consist of a single literal segment
+    if (segments.size() == 1 && segments[0].slot == -1) {
+      return segments[0].text;
+    }
+
+    size_t size = m_template->size();
+    for (const auto& slot : m_values) {
+      size += slot.value.size();
+    }
+
+    string text;
+    text.reserve(size);
+
+    for (const auto& segment : segments) {
+      if (segment.slot != -1 && m_values[segment.slot].set) {
+        text += m_values[segment.slot].value;
+      } else {
+        text += segment.text;
       }
     }
+
+    return text;
   }
 
   void label::replace_defined_values(const label_t& label) {
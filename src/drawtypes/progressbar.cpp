@@ -1,5 +1,6 @@
 #include "drawtypes/progressbar.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "drawtypes/label.hpp"
@@ -14,10 +15,12 @@ namespace drawtypes {
 
   void progressbar::set_fill(label_t&& fill) {
     m_fill = forward<decltype(fill)>(fill);
+    m_cache.clear();
   }
 
   void progressbar::set_empty(label_t&& empty) {
     m_empty = forward<decltype(empty)>(empty);
+    m_cache.clear();
   }
 
   void progressbar::set_indicator(label_t&& indicator) {
@@ -25,26 +28,41 @@ namespace drawtypes {
       m_width--;
     }
     m_indicator = forward<decltype(indicator)>(indicator);
+    m_cache.clear();
   }
 
   void progressbar::set_gradient(bool mode) {
     m_gradient = mode;
+    m_cache.clear();
   }
 
   void progressbar::set_colors(vector<rgba>&& colors) {
     m_colors = forward<decltype(colors)>(colors);
 
     m_colorstep = m_colors.empty() ? 1 : m_width / m_colors.size();
+    m_cache.clear();
   }
 
   string progressbar::output(float percentage) {
-    string output{m_format};
-
     // Get fill/empty widths based on percentage
     unsigned int perc = math_util::cap(percentage, 0.0f, 100.0f);
     unsigned int fill_width = math_util::percentage_to_value(perc, m_width);
     unsigned int empty_width = m_width - fill_width;
 
+    // Without gradient, the color of the whole fill depends on the percentage
+    unsigned int color = 0;
+    if (!m_colors.empty() && !m_gradient) {
+      color = math_util::percentage_to_value<size_t>(perc, m_colors.size() - 1);
+    }
+
+    unsigned int state = fill_width * std::max<size_t>(m_colors.size(), 1) + color;
+    auto cached = m_cache.find(state);
+    if (cached != m_cache.end()) {
+      return cached->second;
+    }
+
+    string output{m_format};
+
     // Output fill icons
     fill(perc, fill_width);
     output = string_util::replace_all(output, "%fill%", m_builder->flush());
@@ -57,6 +75,7 @@ namespace drawtypes {
     m_builder->node_repeat(m_empty, empty_width);
     output = string_util::replace_all(output, "%empty%", m_builder->flush());
 
+    m_cache.emplace(state, output);
     return output;
   }
 
@@ -3,8 +3,6 @@
 
 POLYBAR_NS
 
-signal_receivers_t g_signal_receivers;
-
 /**
  * Create instance
  */
@@ -12,4 +10,19 @@ signal_emitter::make_type signal_emitter::make() {
   return static_cast<signal_emitter&>(*factory_util::singleton<signal_emitter>());
 }
 
+void signal_emitter::set_wakeup(std::function<void()>&& wakeup) {
+  std::lock_guard<std::mutex> guard(m_wakeup_lock);
+  m_wakeup = move(wakeup);
+}
+
+void signal_emitter::dispatch_posted() {
+  for (auto& posted : m_posted) {
+    // Receivers may post the signal again, it is then emitted during the next call
+    emit_fn fn = posted.exchange(nullptr);
+    if (fn != nullptr) {
+      fn(*this);
+    }
+  }
+}
+
 POLYBAR_NS_END
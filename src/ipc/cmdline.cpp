@@ -0,0 +1,129 @@
+#include "ipc/cmdline.hpp"
+
+#include <cstring>
+
+#include "modules/ipc.hpp"
+#include "utils/actions.hpp"
+
+POLYBAR_NS
+
+namespace ipc {
+
+  std::deque<string> split_line(const string& line) {
+    std::deque<string> args;
+    string arg;
+    // Whether an argument was started, it may still be empty (e.g. for '')
+    bool in_arg{false};
+
+    for (size_t i = 0; i < line.size(); i++) {
+      char c = line[i];
+
+      if (c == ' ' || c == '\t') {
+        if (in_arg) {
+          args.emplace_back(move(arg));
+          arg.clear();
+          in_arg = false;
+        }
+        continue;
+      }
+
+      in_arg = true;
+
+      if (c == '\\') {
+        if (++i == line.size()) {
+          throw cmdline_error("Line ends with a backslash");
+        }
+        arg += line[i];
+      } else if (c == '\'') {
+        size_t end = line.find('\'', i + 1);
+        if (end == string::npos) {
+          throw cmdline_error("Unterminated single quote");
+        }
+        arg += line.substr(i + 1, end - i - 1);
+        i = end;
+      } else if (c == '"') {
+        for (i++; i < line.size() && line[i] != '"'; i++) {
+          if (line[i] == '\\' && i + 1 < line.size() && strchr("\"\\$`", line[i + 1]) != nullptr) {
+            i++;
+          }
+          arg += line[i];
+        }
+        if (i == line.size()) {
+          throw cmdline_error("Unterminated double quote");
+        }
+      } else {
+        arg += c;
+      }
+    }
+
+    if (in_arg) {
+      args.emplace_back(move(arg));
+    }
+
+    return args;
+  }
+
+  std::pair<type_t, string> parse_message(std::deque<string> args) {
+    if (args.size() < 2) {
+      throw cmdline_error("Expected a message type and a payload");
+    }
+
+    const string ipc_type{args.front()};
+    args.pop_front();
+    string ipc_payload{args.front()};
+    args.pop_front();
+
+    type_t type = TYPE_ERR;
+
+    if (ipc_type == "hook") {
+      /*
+       * The hook type is deprecated. Its contents are translated into a hook action.
+       */
+      if (args.size() != 1) {
+        throw cmdline_error("Mismatched number of arguments for hook, expected 1, got "s + to_string(args.size()));
+      }
+
+      if (ipc_payload.find("module/") == 0) {
+        ipc_payload.erase(0, strlen("module/"));
+      }
+
+      // Hook commands use 1-indexed hooks but actions use 0-indexed ones
+      int hook_index = std::stoi(args.front()) - 1;
+      args.pop_front();
+
+      type = to_integral(v0::ipc_type::ACTION);
+      ipc_payload =
+          actions_util::get_action_string(ipc_payload, modules::ipc_module::EVENT_HOOK, to_string(hook_index));
+    } else if (ipc_type == "action") {
+      type = to_integral(v0::ipc_type::ACTION);
+      /*
+       * Alternatively polybar-msg action <module name> <action> <data>
+       * is also accepted
+       */
+      if (!args.empty()) {
+        string name = ipc_payload;
+        string action = args.front();
+        args.pop_front();
+        string data{};
+        if (!args.empty()) {
+          data = args.front();
+          args.pop_front();
+        }
+
+        ipc_payload = actions_util::get_action_string(name, action, data);
+      }
+    } else if (ipc_type == "cmd") {
+      type = to_integral(v0::ipc_type::CMD);
+    } else {
+      throw cmdline_error("\"" + ipc_type + "\" is not a valid message type.");
+    }
+
+    if (!args.empty()) {
+      throw cmdline_error("Too many arguments");
+    }
+
+    return {type, ipc_payload};
+  }
+}  // namespace ipc
+
+POLYBAR_NS_END
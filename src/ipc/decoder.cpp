@@ -3,6 +3,8 @@
 #include <cassert>
 #include <cstring>
 
+#include "utils/string.hpp"
+
 POLYBAR_NS
 
 namespace ipc {
@@ -37,10 +39,10 @@ namespace ipc {
         remain -= num_read;
 
         /*
-         * If an empty message arrives, we need to explicitly trigger this because there is no further data that would
-         * call process_msg_data.
+         * If an empty message arrives, we need to explicitly trigger this because process_msg_data would not consume
+         * any data (and there may be no further data at all).
          */
-        if (remain == 0 && state == state::PAYLOAD && to_read_buf == 0) {
+        if (state == state::PAYLOAD && to_read_buf == 0) {
           ssize_t num_read_data = process_msg_data(data + buf_pos, remain);
           assert(num_read_data == 0);
           (void)num_read_data;
@@ -131,5 +133,18 @@ namespace ipc {
 
     return num_read;
   }
+
+  vector<string> decode_batch(const string& payload) {
+    vector<string> actions;
+    for (auto&& action : string_util::split(payload, '\n')) {
+      if (action.empty()) {
+        continue;
+      } else if (action.front() != '#') {
+        throw decoder::error("Batches may only contain action strings, got '" + action + "'");
+      }
+      actions.emplace_back(move(action));
+    }
+    return actions;
+  }
 }  // namespace ipc
 POLYBAR_NS_END
@@ -4,6 +4,8 @@
 #include <cstring>
 #include <cstdint>
 
+#include "utils/string.hpp"
+
 POLYBAR_NS
 
 namespace ipc {
@@ -30,5 +32,9 @@ namespace ipc {
     return encode<string>(type, payload);
   }
 
+  string encode_batch(const vector<string>& actions) {
+    return string_util::join(actions, "\n");
+  }
+
 }  // namespace ipc
 POLYBAR_NS_END
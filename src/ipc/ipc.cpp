@@ -64,12 +64,16 @@ namespace ipc {
           m_log.err("libuv error while listening to IPC socket: %s", uv_strerror(e.status));
           m_socket->close();
         });
+
+    m_sig.attach(this);
   }
 
   /**
    * Deconstruct ipc handler
    */
   ipc::~ipc() {
+    m_sig.detach(this);
+
     m_log.trace("ipc: Removing named pipe at: %s", m_pipe_path);
     if (unlink(m_pipe_path.c_str()) == -1) {
       m_log.err("Failed to delete ipc named pipe: %s", strerror(errno));
@@ -88,6 +92,10 @@ namespace ipc {
       case v0::ipc_type::ACTION:
         m_log.info("Received ipc action: '%s'", msg);
         return m_sig.emit(signals::ipc::action{msg});
+      case v0::ipc_type::SESSION:
+      case v0::ipc_type::SUBSCRIBE:
+      case v0::ipc_type::BATCH:
+        break;
     }
 
     assert(false);
@@ -110,26 +118,7 @@ namespace ipc {
   void ipc::on_connection() {
     auto connection = make_unique<ipc::connection>(
         m_loop, [this](ipc::connection& c, uint8_t, type_t type, const vector<uint8_t>& msg) {
-          vector<uint8_t> response;
-
-          if (type == to_integral(v0::ipc_type::ACTION) || type == to_integral(v0::ipc_type::CMD)) {
-            auto ipc_type = static_cast<v0::ipc_type>(type);
-            string str;
-            str.insert(str.end(), msg.begin(), msg.end());
-            if (trigger_ipc(ipc_type, str)) {
-              response = encode(TYPE_OK);
-            } else {
-              response = encode(TYPE_ERR, "Error while executing ipc message, see polybar log for details.");
-            }
-          } else {
-            response = encode(TYPE_ERR, "Unrecognized IPC message type " + to_string(type));
-          }
-          c.client_pipe->write(
-              response, [this, &c]() { remove_client(c); },
-              [this, &c](const auto& e) {
-                m_log.err("ipc: libuv error while writing to IPC socket: %s", uv_strerror(e.status));
-                remove_client(c);
-              });
+          on_message(c, type, msg);
         });
 
     auto& c = *connection;
@@ -142,12 +131,7 @@ namespace ipc {
           } catch (const decoder::error& e) {
             m_log.err("ipc: Failed to decode IPC message (reason: %s)", e.what());
 
-            c.client_pipe->write(
-                encode(TYPE_ERR, "Invalid binary message format: "s + e.what()), [this, &c]() { remove_client(c); },
-                [this, &c](const auto& e) {
-                  m_log.err("ipc: libuv error while writing to IPC socket: %s", uv_strerror(e.status));
-                  remove_client(c);
-                });
+            send(c, encode(TYPE_ERR, "Invalid binary message format: "s + e.what()), true);
           }
         },
         [this, &c]() { remove_client(c); },
@@ -160,8 +144,132 @@ namespace ipc {
     m_log.info("ipc: New connection (%d clients)", connections.size());
   }
 
+  /**
+   * Handles a single message from a client and sends the response
+   */
+  void ipc::on_message(connection& c, type_t type, const vector<uint8_t>& msg) {
+    vector<uint8_t> response;
+    string str{msg.begin(), msg.end()};
+
+    if (type == to_integral(v0::ipc_type::ACTION) || type == to_integral(v0::ipc_type::CMD)) {
+      if (trigger_ipc(static_cast<v0::ipc_type>(type), str)) {
+        response = encode(TYPE_OK);
+      } else {
+        response = encode(TYPE_ERR, "Error while executing ipc message, see polybar log for details.");
+      }
+    } else if (type == to_integral(v0::ipc_type::BATCH)) {
+      try {
+        auto actions = decode_batch(str);
+        m_log.info("Received ipc batch of %zu actions", actions.size());
+        if (actions.empty() || m_sig.emit(signals::ipc::batch{actions})) {
+          response = encode(TYPE_OK);
+        } else {
+          response = encode(TYPE_ERR, "Error while executing ipc message, see polybar log for details.");
+        }
+      } catch (const decoder::error& e) {
+        response = encode(TYPE_ERR, e.what());
+      }
+    } else if (type == to_integral(v0::ipc_type::SESSION)) {
+      c.persistent = true;
+      response = encode(TYPE_OK);
+    } else if (type == to_integral(v0::ipc_type::SUBSCRIBE)) {
+      std::set<string> events;
+      for (auto&& event : string_util::split(str, ' ')) {
+        if (event.empty()) {
+          continue;
+        } else if (event != v0::EVENT_OUTPUT && event != v0::EVENT_VISIBILITY) {
+          response = encode(TYPE_ERR, "Unrecognized event '" + event + "'");
+          break;
+        }
+        events.insert(move(event));
+      }
+
+      if (response.empty()) {
+        c.persistent = true;
+        c.events = move(events);
+        if (!c.subscribed) {
+          c.subscribed = true;
+          m_subscribers++;
+        }
+        m_log.info("ipc: New subscriber (events: '%s', %zu subscribers)", str, m_subscribers);
+        response = encode(TYPE_OK);
+      }
+    } else {
+      response = encode(TYPE_ERR, "Unrecognized IPC message type " + to_string(type));
+    }
+
+    send(c, move(response), !c.persistent);
+  }
+
+  /**
+   * Writes the data to the client
+   *
+   * The data is kept alive until the write finished. If close_after is set, the connection is closed afterwards.
+   */
+  void ipc::send(connection& c, vector<uint8_t>&& data, bool close_after) {
+    auto buf = make_shared<vector<uint8_t>>(move(data));
+    c.client_pipe->write(
+        *buf,
+        [this, &c, buf, close_after]() {
+          if (close_after) {
+            remove_client(c);
+          }
+        },
+        [this, &c, buf](const auto& e) {
+          m_log.err("ipc: libuv error while writing to IPC socket: %s", uv_strerror(e.status));
+          remove_client(c);
+        });
+  }
+
+  /**
+   * Sends an event to all clients subscribed to it
+   */
+  void ipc::publish(const string& event, const string& data) {
+    vector<connection*> failed;
+
+    for (auto&& c : connections) {
+      if (!c->subscribed || (!c->events.empty() && c->events.count(event) == 0)) {
+        continue;
+      }
+
+      try {
+        send(*c, encode(v0::TYPE_EVENT, event + " " + data), false);
+      } catch (const std::exception& err) {
+        m_log.err("ipc: Failed to send event to subscriber (reason: %s)", err.what());
+        failed.push_back(c.get());
+      }
+    }
+
+    for (auto* c : failed) {
+      remove_client(*c);
+    }
+  }
+
+  bool ipc::on(const signals::ui::module_output& evt) {
+    if (m_subscribers > 0) {
+      auto output = evt.cast();
+      publish(v0::EVENT_OUTPUT, output.first + " " + output.second);
+    }
+    return false;
+  }
+
+  bool ipc::on(const signals::ui::visibility_change& evt) {
+    if (m_subscribers > 0) {
+      publish(v0::EVENT_VISIBILITY, evt.cast().second ? "visible" : "hidden");
+    }
+    return false;
+  }
+
   void ipc::remove_client(connection& conn) {
-    connections.erase(connections.find(conn));
+    auto it = connections.find(conn);
+    if (it == connections.end()) {
+      return;
+    }
+
+    if (conn.subscribed) {
+      m_subscribers--;
+    }
+    connections.erase(it);
   }
 
   ipc::connection::connection(loop& loop, cb msg_callback)
@@ -1,8 +1,11 @@
+#include <algorithm>
+
 #include "components/bar.hpp"
 #include "components/command_line.hpp"
 #include "components/config.hpp"
 #include "components/config_parser.hpp"
 #include "components/controller.hpp"
+#include "components/startup_profiler.hpp"
 #include "ipc/ipc.hpp"
 #include "utils/env.hpp"
 #include "utils/inotify.hpp"
@@ -27,6 +30,7 @@ int main(int argc, char** argv) {
       command_line::option{"-w", "--print-wmname", "Print the generated WM_NAME and exit"},
       command_line::option{"-s", "--stdout", "Output data to stdout instead of drawing it to the X window"},
       command_line::option{"-p", "--png", "Save png snapshot to FILE after running for 3 seconds", "FILE"},
+      command_line::option{"-P", "--profile-startup", "Print the time spent in each startup phase once the bar is drawn"},
   };
   // clang-format on
 
@@ -59,11 +63,17 @@ int main(int argc, char** argv) {
       return EXIT_SUCCESS;
     }
 
+    startup_profiler& profiler{startup_profiler::make()};
+    if (cli->has("profile-startup")) {
+      profiler.enable();
+    }
+
     loop loop{};
 
     //==================================================
     // Connect to X server
     //==================================================
+    auto timer = profiler.start("Connect to X server");
     auto xcb_error = 0;
     auto xcb_screen = 0;
     auto xcb_connection = xcb_connect(nullptr, &xcb_screen);
@@ -76,6 +86,7 @@ int main(int argc, char** argv) {
 
     connection& conn{connection::make(xcb_connection, xcb_screen)};
     conn.ensure_event_mask(conn.root(), XCB_EVENT_MASK_PROPERTY_CHANGE);
+    timer.reset();
 
     //==================================================
     // List available XRandR entries
@@ -100,13 +111,6 @@ int main(int argc, char** argv) {
     //==================================================
     string confpath;
 
-    // Make sure a bar name is passed in
-    if (cli->has(1)) {
-      fprintf(stderr, "Unrecognized argument \"%s\"\n", cli->get(1).c_str());
-      cli->usage();
-      return EXIT_FAILURE;
-    }
-
     if (cli->has("config")) {
       confpath = cli->get("config");
     } else {
@@ -122,13 +126,22 @@ int main(int argc, char** argv) {
       throw application_error("Define configuration using --config=PATH");
     }
 
-    string barname;
-    if (cli->has(0)) {
-      barname = cli->get(0);
+    // Every positional argument names a bar, all of them are hosted in this process
+    vector<string> barnames;
+    for (size_t i = 0; cli->has(i); i++) {
+      barnames.emplace_back(cli->get(i));
     }
 
+    timer = profiler.start("Parse config");
     config_parser parser{logger, move(confpath)};
-    config conf = parser.parse(move(barname));
+    vector<config> confs;
+    confs.reserve(std::max<size_t>(barnames.size(), 1));
+    confs.emplace_back(parser.parse(barnames.empty() ? ""s : barnames.front()));
+    for (size_t i = 1; i < barnames.size(); i++) {
+      confs.emplace_back(confs.front().with_bar(barnames[i]));
+    }
+    const config& conf = confs.front();
+    timer.reset();
 
     //==================================================
     // Dump requested data
@@ -147,7 +160,8 @@ int main(int argc, char** argv) {
     //==================================================
     unique_ptr<ipc::ipc> ipc{};
 
-    if (conf.get(conf.section(), "enable-ipc", false)) {
+    if (std::any_of(confs.begin(), confs.end(),
+            [](const config& bar_conf) { return bar_conf.get(bar_conf.section(), "enable-ipc", false); })) {
       try {
         ipc = ipc::ipc::make(loop);
       } catch (const std::exception& e) {
@@ -156,7 +170,7 @@ int main(int argc, char** argv) {
       }
     }
 
-    auto ctrl = controller::make((bool)ipc, loop, conf);
+    auto ctrl = controller::make((bool)ipc, loop, confs);
 
     if (!ctrl->run(cli->has("stdout"), cli->get("png"), cli->has("reload"))) {
       reload = true;
@@ -173,6 +187,7 @@ int main(int argc, char** argv) {
 
   if (reload) {
     logger.info("Re-launching application...");
+    logger.flush();
     process_util::exec(move(argv[0]), move(argv));
   }
 
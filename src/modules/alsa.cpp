@@ -3,12 +3,14 @@
 #include "adapters/alsa/control.hpp"
 #include "adapters/alsa/generic.hpp"
 #include "adapters/alsa/mixer.hpp"
+#include "adapters/alsa/poller.hpp"
 #include "drawtypes/label.hpp"
 #include "drawtypes/progressbar.hpp"
 #include "drawtypes/ramp.hpp"
 #include "modules/meta/base.inl"
 #include "settings.hpp"
 #include "utils/math.hpp"
+#include "utils/scope.hpp"
 
 POLYBAR_NS
 
@@ -69,9 +71,19 @@ namespace modules {
       if (m_mixer.empty()) {
         throw module_error("No configured mixers");
       }
-    } catch (const mixer_error& err) {
-      throw module_error(err.what());
-    } catch (const control_error& err) {
+
+      m_poller = std::make_unique<poller>();
+      for (auto&& m : m_mixer) {
+        if (m.second) {
+          m_poller->add(m.second);
+        }
+      }
+      for (auto&& c : m_ctrl) {
+        if (c.second) {
+          m_poller->add(c.second);
+        }
+      }
+    } catch (const alsa_exception& err) {
       throw module_error(err.what());
     }
 
@@ -94,32 +106,56 @@ namespace modules {
     }
   }
 
+  /**
+   * Starts the module thread, the handles are closed whenever the thread exits (also after an error)
+   */
+  void alsa_module::start() {
+    this->module<alsa_module>::start();
+    m_mainthread = thread([this] {
+      scope_util::on_exit release_handles([this] { release(); });
+      runner();
+    });
+  }
+
+  /**
+   * Wake up the module thread, it closes the handles once it left the poller
+   */
   void alsa_module::teardown() {
-    m_mixer.clear();
-    m_ctrl.clear();
-    snd_config_update_free_global();
+    // The module thread may have released the handles already
+    if (m_poller) {
+      m_poller->interrupt();
+    }
   }
 
-  bool alsa_module::has_event() {
-    // Poll for mixer and control events
+  /**
+   * Wait for events on all mixers and controls at once
+   */
+  void alsa_module::idle() {
     try {
-      if (m_mixer[mixer::MASTER] && m_mixer[mixer::MASTER]->wait(25)) {
-        return true;
-      }
-      if (m_mixer[mixer::SPEAKER] && m_mixer[mixer::SPEAKER]->wait(25)) {
-        return true;
-      }
-      if (m_mixer[mixer::HEADPHONE] && m_mixer[mixer::HEADPHONE]->wait(25)) {
-        return true;
-      }
-      if (m_ctrl[control::HEADPHONE] && m_ctrl[control::HEADPHONE]->wait(25)) {
-        return true;
-      }
+      m_pending_events = m_poller->wait() || m_pending_events;
     } catch (const alsa_exception& e) {
       m_log.err("%s: %s", name(), e.what());
+      sleep(1s);
     }
+  }
 
-    return false;
+  /**
+   * Close all mixers and controls
+   *
+   * Only called when the module thread exits, no other thread waits on the handles anymore.
+   */
+  void alsa_module::release() {
+    std::lock_guard<std::mutex> guard(m_updatelock);
+    m_poller.reset();
+    m_mixer.clear();
+    m_ctrl.clear();
+    snd_config_update_free_global();
+  }
+
+  bool alsa_module::has_event() {
+    bool pending = m_pending_events;
+    m_pending_events = false;
+    return pending;
   }
 
   bool alsa_module::update() {
@@ -14,103 +14,65 @@ POLYBAR_NS
 namespace modules {
   template class module<battery_module>;
 
-  template <typename ValueReader>
-  typename ValueReader::return_type read(ValueReader& reader) {
-    std::lock_guard<ValueReader> guard(reader);
-    return reader.read();
-  }
-
   /**
    * Bootstrap module by setting up required components
    */
   battery_module::battery_module(const bar_settings& bar, string name_, const config& config)
-      : inotify_module<battery_module>(bar, move(name_), config) {
+      : module<battery_module>(bar, move(name_), config) {
     // Load configuration values
     m_fullat = std::min(m_conf.get(name(), "full-at", m_fullat), 100);
     m_lowat = std::max(m_conf.get(name(), "low-at", m_lowat), 0);
-    m_interval = m_conf.get<decltype(m_interval)>(name(), "poll-interval", 5s);
-    m_lastpoll = chrono::steady_clock::now();
+    // The interval is configured in seconds, fractions are allowed
+    m_interval = chrono::duration_cast<decltype(m_interval)>(
+        m_conf.get<chrono::duration<double>>(name(), "poll-interval", 5s));
 
     auto path_adapter = string_util::replace(PATH_ADAPTER, "%adapter%", m_conf.get(name(), "adapter", "ADP1"s)) + "/";
     auto path_battery = string_util::replace(PATH_BATTERY, "%battery%", m_conf.get(name(), "battery", "BAT0"s)) + "/";
 
-    // Make state reader
-    if (file_util::exists((m_fstate = path_battery + "status"))) {
-      m_state_reader =
-          make_unique<state_reader>([=] { return file_util::contents(m_fstate).compare(0, 8, "Charging") == 0; });
-    } else if (file_util::exists((m_fstate = path_adapter + "online"))) {
-      m_state_reader = make_unique<state_reader>([=] { return file_util::contents(m_fstate).compare(0, 1, "1") == 0; });
+    // Open state attribute
+    if (file_util::exists(path_battery + "status")) {
+      m_state_attr = make_unique<power_supply::attribute>(path_battery + "status");
+      m_charging_value = "Charging";
+    } else if (file_util::exists(path_adapter + "online")) {
+      m_state_attr = make_unique<power_supply::attribute>(path_adapter + "online");
+      m_charging_value = "1";
     } else {
       throw module_error("No suitable way to get current charge state");
     }
 
-    // Make capacity reader
-    if ((m_fcapnow = file_util::pick({path_battery + "charge_now", path_battery + "energy_now"})).empty()) {
+    // Open capacity attributes
+    string path;
+    if ((path = file_util::pick({path_battery + "charge_now", path_battery + "energy_now"})).empty()) {
       throw module_error("No suitable way to get current capacity value");
-    } else if ((m_fcapfull = file_util::pick({path_battery + "charge_full", path_battery + "energy_full"})).empty()) {
-      throw module_error("No suitable way to get max capacity value");
     }
+    m_capnow_attr = make_unique<power_supply::attribute>(path);
 
-    m_capacity_reader = make_unique<capacity_reader>([=] {
-      auto cap_now = std::strtoul(file_util::contents(m_fcapnow).c_str(), nullptr, 10);
-      auto cap_max = std::strtoul(file_util::contents(m_fcapfull).c_str(), nullptr, 10);
-      return math_util::percentage(cap_now, 0UL, cap_max);
-    });
+    if ((path = file_util::pick({path_battery + "charge_full", path_battery + "energy_full"})).empty()) {
+      throw module_error("No suitable way to get max capacity value");
+    }
+    m_capfull_attr = make_unique<power_supply::attribute>(path);
 
-    // Make rate reader
-    if ((m_fvoltage = file_util::pick({path_battery + "voltage_now"})).empty()) {
+    // Open rate attributes
+    if ((path = file_util::pick({path_battery + "voltage_now"})).empty()) {
       throw module_error("No suitable way to get current voltage value");
-    } else if ((m_frate = file_util::pick({path_battery + "current_now", path_battery + "power_now"})).empty()) {
-      throw module_error("No suitable way to get current charge rate value");
     }
+    m_voltage_attr = make_unique<power_supply::attribute>(path);
 
-    m_rate_reader = make_unique<rate_reader>([this] {
-      unsigned long rate{static_cast<unsigned long>(std::abs(std::strtol(file_util::contents(m_frate).c_str(), nullptr, 10)))};
-      unsigned long volt{std::strtoul(file_util::contents(m_fvoltage).c_str(), nullptr, 10) / 1000UL};
-      unsigned long now{std::strtoul(file_util::contents(m_fcapnow).c_str(), nullptr, 10)};
-      unsigned long max{std::strtoul(file_util::contents(m_fcapfull).c_str(), nullptr, 10)};
-      unsigned long cap{read(*m_state_reader) ? max - now : now};
-
-      if (rate && volt && cap) {
-        auto remaining = (cap / volt);
-        auto current_rate = (rate / volt);
-
-        if (remaining && current_rate) {
-          return 3600UL * remaining / current_rate;
-        }
-      }
-
-      return 0UL;
-    });
-
-    // Make consumption reader
-    m_consumption_reader = make_unique<consumption_reader>([this] {
-      float consumption;
-
-      // if the rate we found was the current, calculate power (P = I*V)
-      if (string_util::contains(m_frate, "current_now")) {
-        unsigned long current{std::strtoul(file_util::contents(m_frate).c_str(), nullptr, 10)};
-        unsigned long voltage{std::strtoul(file_util::contents(m_fvoltage).c_str(), nullptr, 10)};
+    if ((path = file_util::pick({path_battery + "current_now", path_battery + "power_now"})).empty()) {
+      throw module_error("No suitable way to get current charge rate value");
+    }
+    m_rate_attr = make_unique<power_supply::attribute>(path);
+    m_rate_is_current = string_util::contains(path, "current_now");
 
-        consumption = ((voltage / 1000.0) * (current / 1000.0)) / 1e6;
-      } else {
-        // if it was power, just use as is
-        unsigned long power{std::strtoul(file_util::contents(m_frate).c_str(), nullptr, 10)};
+    try {
+      m_uevents = make_unique<power_supply::uevent_monitor>();
+    } catch (const system_error& err) {
+      m_log.warn("%s: Falling back to polling only (%s)", name(), err.what());
 
-        consumption = power / 1e6;
+      if (m_interval <= 0ms) {
+        m_interval = 5s;
       }
-
-      // convert to string with 2 decimmal places
-      string rtn(16, '\0'); // 16 should be plenty big. Cant see it needing more than 6/7..
-      auto written = std::snprintf(&rtn[0], rtn.size(), "%.2f", consumption);
-      rtn.resize(written);
-
-      return rtn;
-    });
-
-    // Load state and capacity level
-    m_state = current_state();
-    m_percentage = current_percentage();
+    }
 
     // Add formats and elements
     m_formatter->add(FORMAT_CHARGING, TAG_LABEL_CHARGING,
@@ -151,9 +113,12 @@ namespace modules {
       m_label_full = load_optional_label(m_conf, name(), TAG_LABEL_FULL, "%percentage%%");
     }
 
-    // Create inotify watches
-    watch(m_fcapnow, IN_ACCESS);
-    watch(m_fstate, IN_ACCESS);
+    // Only read rate and voltage values if they are displayed
+    for (const auto& label : {m_label_charging, m_label_discharging, m_label_low, m_label_full}) {
+      if (label && (label->has_token("%time%") || label->has_token("%consumption%"))) {
+        m_needs_rate = true;
+      }
+    }
 
     // Setup time if token is used
     if ((m_label_charging && m_label_charging->has_token("%time%")) ||
@@ -167,11 +132,12 @@ namespace modules {
   }
 
   /**
-   * Dispatch the subthread used to update the
+   * Dispatch the main thread and the subthread used to update the
    * charging animation when the module is started
    */
   void battery_module::start() {
-    this->inotify_module::start();
+    this->module::start();
+    m_mainthread = thread(&battery_module::runner, this);
     // We only start animation thread if there is at least one animation.
     if (m_animation_charging || m_animation_discharging || m_animation_low) {
       m_subthread = thread(&battery_module::subthread, this);
@@ -179,59 +145,108 @@ namespace modules {
   }
 
   /**
-   * Release wake lock when stopping the module
+   * Wake up the main thread and join the animation thread when stopping the module
    */
   void battery_module::teardown() {
+    if (m_uevents) {
+      m_uevents->interrupt();
+    }
+
     if (m_subthread.joinable()) {
       m_subthread.join();
     }
   }
 
   /**
-   * Idle between polling inotify watches for events.
-   *
-   * If the defined interval has been reached, trigger a manual
-   * poll in case the inotify events aren't fired.
+   * Time to wait for a uevent before polling the values again
    *
-   * This fallback is needed because some systems won't
-   * report inotify events for files on sysfs.
+   * Polls quickly for a short while after the state changed and falls back
+   * to the configured poll-interval once the values are steady. A negative
+   * value means that only uevents trigger an update.
    */
-  void battery_module::idle() {
-    if (m_interval.count() > 0) {
-      auto now = chrono::steady_clock::now();
-      if (chrono::duration_cast<decltype(m_interval)>(now - m_lastpoll) > m_interval) {
-        m_lastpoll = now;
-        m_log.info("%s: Polling values (inotify fallback)", name());
-        on_event({});
-      }
+  chrono::milliseconds battery_module::next_timeout() const {
+    if (m_fast_polls > 0 && (m_interval <= 0ms || m_interval > FAST_INTERVAL)) {
+      return FAST_INTERVAL;
     }
 
-    this->inotify_module::idle();
+    return m_interval > 0ms ? m_interval : -1ms;
   }
 
   /**
-   * Update values when tracked files have changed
+   * Main thread: Update whenever a power_supply uevent arrives or the timeout expires
    */
-  bool battery_module::on_event(const inotify_event& event) {
-    auto state = current_state();
-    auto percentage = current_percentage();
+  void battery_module::runner() {
+    m_log.trace("%s: Thread id = %i", name(), concurrency_util::thread_id(this_thread::get_id()));
+
+    try {
+      {
+        // Warm up module output before entering the loop
+        std::lock_guard<std::mutex> guard(m_updatelock);
+        update(true);
+        broadcast();
+      }
+
+      while (running()) {
+        bool uevent{false};
+
+        if (m_uevents) {
+          uevent = m_uevents->wait(next_timeout());
+        } else {
+          sleep(next_timeout());
+        }
 
-    // Reset timer to avoid unnecessary polling
-    m_lastpoll = chrono::steady_clock::now();
+        if (!running()) {
+          break;
+        }
 
-    if (event.is_valid) {
-      m_log.trace("%s: Inotify event reported for %s", name(), event.filename);
+        if (uevent) {
+          m_log.trace("%s: Received power_supply uevent", name());
+          m_fast_polls = FAST_POLLS;
+        } else if (m_fast_polls > 0) {
+          m_fast_polls--;
+        }
 
-      if (state == m_state && percentage == m_percentage && m_unchanged--) {
-        return false;
+        std::lock_guard<std::mutex> guard(m_updatelock);
+        if (update()) {
+          broadcast();
+        }
       }
+    } catch (const exception& err) {
+      halt(err.what());
+    }
+  }
 
-      m_unchanged = SKIP_N_UNCHANGED;
+  /**
+   * Read all values and update the labels
+   *
+   * @param force Update the labels even if state and percentage are unchanged
+   * @return true if the output may have changed
+   */
+  bool battery_module::update(bool force) {
+    auto values = read_values();
+    auto state = get_state(values);
+    auto percentage = get_percentage(values);
+
+    if (state != m_state) {
+      m_fast_polls = FAST_POLLS;
+    } else if (!force && percentage == m_percentage && !m_needs_rate) {
+      return false;
     }
 
     m_state = state;
     m_percentage = percentage;
 
+    string time;
+    string consumption;
+
+    if (m_needs_rate) {
+      consumption = get_consumption(values);
+
+      if (m_state != battery_module::state::FULL && !m_timeformat.empty()) {
+        time = get_time(values);
+      }
+    }
+
     const auto replace_tokens = [&](label_t& label) {
       if (!label) {
         return;
@@ -240,10 +255,10 @@ namespace modules {
       label->reset_tokens();
       label->replace_token("%percentage%", to_string(clamp_percentage(m_percentage, m_state)));
       label->replace_token("%percentage_raw%", to_string(m_percentage));
-      label->replace_token("%consumption%", current_consumption());
+      label->replace_token("%consumption%", consumption);
 
       if (m_state != battery_module::state::FULL && !m_timeformat.empty()) {
-        label->replace_token("%time%", current_time());
+        label->replace_token("%time%", time);
       }
     };
 
@@ -306,13 +321,30 @@ namespace modules {
   }
 
   /**
-   * Get the current battery state
+   * Read all needed sysfs attributes in a single sweep
    */
-  battery_module::state battery_module::current_state() {
-    auto charge = read(*m_capacity_reader);
+  battery_module::values battery_module::read_values() const {
+    values v;
+    v.charging = m_state_attr->read().compare(0, m_charging_value.size(), m_charging_value) == 0;
+    v.capacity_now = m_capnow_attr->read_ulong();
+    v.capacity_full = m_capfull_attr->read_ulong();
+
+    if (m_needs_rate) {
+      v.rate = static_cast<unsigned long>(std::abs(m_rate_attr->read_long()));
+      v.voltage = m_voltage_attr->read_ulong();
+    }
+
+    return v;
+  }
+
+  /**
+   * Get the battery state
+   */
+  battery_module::state battery_module::get_state(const values& v) const {
+    auto charge = get_percentage(v);
     if (charge >= m_fullat) {
       return battery_module::state::FULL;
-    } else if (!read(*m_state_reader)) {
+    } else if (!v.charging) {
       return charge <= m_lowat ? battery_module::state::LOW : battery_module::state::DISCHARGING;
     } else {
       return battery_module::state::CHARGING;
@@ -320,10 +352,10 @@ namespace modules {
   }
 
   /**
-   * Get the current capacity level
+   * Get the capacity level
    */
-  int battery_module::current_percentage() {
-    return read(*m_capacity_reader);
+  int battery_module::get_percentage(const values& v) const {
+    return math_util::percentage(v.capacity_now, 0UL, v.capacity_full);
   }
 
   int battery_module::clamp_percentage(int percentage, state state) const {
@@ -334,21 +366,49 @@ namespace modules {
   }
 
   /**
-   * Get the current power consumption
+   * Get the power consumption
    */
-  string battery_module::current_consumption() {
-    return read(*m_consumption_reader);
+  string battery_module::get_consumption(const values& v) const {
+    float consumption;
+
+    // if the rate we found was the current, calculate power (P = I*V)
+    if (m_rate_is_current) {
+      consumption = ((v.voltage / 1000.0) * (v.rate / 1000.0)) / 1e6;
+    } else {
+      // if it was power, just use as is
+      consumption = v.rate / 1e6;
+    }
+
+    // convert to string with 2 decimmal places
+    string rtn(16, '\0'); // 16 should be plenty big. Cant see it needing more than 6/7..
+    auto written = std::snprintf(&rtn[0], rtn.size(), "%.2f", consumption);
+    rtn.resize(written);
+
+    return rtn;
   }
 
   /**
    * Get estimate of remaining time until fully dis-/charged
    */
-  string battery_module::current_time() {
+  string battery_module::get_time(const values& v) const {
     struct tm t {
       0, 0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr
     };
 
-    chrono::seconds sec{read(*m_rate_reader)};
+    unsigned long seconds{0};
+    unsigned long volt{v.voltage / 1000UL};
+    unsigned long cap{v.charging ? v.capacity_full - v.capacity_now : v.capacity_now};
+
+    if (v.rate && volt && cap) {
+      auto remaining = (cap / volt);
+      auto current_rate = (v.rate / volt);
+
+      if (remaining && current_rate) {
+        seconds = 3600UL * remaining / current_rate;
+      }
+    }
+
+    chrono::seconds sec{seconds};
     if (sec.count() > 0) {
       t.tm_hour = chrono::duration_cast<chrono::hours>(sec).count();
       sec -= chrono::seconds{3600 * t.tm_hour};
@@ -17,6 +17,7 @@ namespace modules {
   ipc_module::ipc_module(const bar_settings& bar, string name_, const config& config)
       : module<ipc_module>(bar, move(name_), config) {
     m_router->register_action_with_data(EVENT_SEND, [this](const std::string& data) { action_send(data); });
+    m_router->register_action_with_data(EVENT_SET, [this](const std::string& data) { action_set(data); });
     m_router->register_action_with_data(EVENT_HOOK, [this](const std::string& data) { action_hook(data); });
     m_router->register_action(EVENT_NEXT, [this]() { action_next(); });
     m_router->register_action(EVENT_PREV, [this]() { action_prev(); });
@@ -162,6 +163,23 @@ namespace modules {
     update_output();
   }
 
+  /**
+   * Sets the value of a named label token
+   *
+   * The data has the form `<name>=<value>` and replaces `%<name>%` in the label.
+   */
+  void ipc_module::action_set(const string& data) {
+    size_t pos = data.find('=');
+
+    if (pos == 0 || pos == string::npos) {
+      m_log.err("%s: Set action expects data of the form '<name>=<value>', got '%s'", name(), data);
+      return;
+    }
+
+    m_tokens[data.substr(0, pos)] = data.substr(pos + 1);
+    update_output();
+  }
+
   void ipc_module::action_hook(const string& data) {
     try {
       int hook = std::stoi(data);
@@ -189,6 +207,8 @@ namespace modules {
   }
 
   void ipc_module::action_reset() {
+    m_tokens.clear();
+
     if (has_initial()) {
       set_hook(m_initial);
     } else {
@@ -254,6 +274,9 @@ namespace modules {
   void ipc_module::update_output() {
     if (m_label) {
       m_label->reset_tokens();
+      for (const auto& token : m_tokens) {
+        m_label->replace_token("%" + token.first + "%", token.second);
+      }
       m_label->replace_token("%output%", m_output);
     }
     broadcast();
@@ -1,5 +1,6 @@
 #include "modules/meta/base.hpp"
 
+#include <atomic>
 #include <utility>
 
 #include "components/builder.hpp"
@@ -8,6 +9,12 @@
 POLYBAR_NS
 
 namespace modules {
+  size_t next_generation() {
+    // Generation 0 is the empty output every module starts with
+    static std::atomic<size_t> generation{1};
+    return generation++;
+  }
+
   // module_format {{{
 
   string module_format::decorate(builder* builder, string output) {
@@ -1,5 +1,7 @@
 #include "modules/meta/factory.hpp"
 
+#include <set>
+
 #include "modules/meta/all.hpp"
 
 POLYBAR_NS
@@ -119,6 +121,41 @@ namespace modules {
       throw application_error("Unknown module: " + type);
     }
   }
+
+  bool needs_main_thread(const string& type) {
+    // clang-format off
+    static const std::set<string> types{
+      TRAY_TYPE,
+      XBACKLIGHT_TYPE,
+      XWINDOW_TYPE,
+      XWORKSPACES_TYPE,
+      XKEYBOARD_TYPE,
+      // libcurl's implicit global initialization is not thread-safe
+      GITHUB_TYPE,
+      // Calls setlocale(), which changes the locale of the whole process
+      BATTERY_TYPE,
+    };
+    // clang-format on
+
+    return types.find(type) != types.end();
+  }
+
+  bool is_bar_specific(const string& type) {
+    // clang-format off
+    static const std::set<string> types{
+      TRAY_TYPE,
+      XBACKLIGHT_TYPE,
+      XWINDOW_TYPE,
+      XWORKSPACES_TYPE,
+      BSPWM_TYPE,
+      I3_TYPE,
+      // The menu state is changed by clicking on it
+      MENU_TYPE,
+    };
+    // clang-format on
+
+    return types.find(type) != types.end();
+  }
 } // namespace modules
 
 POLYBAR_NS_END
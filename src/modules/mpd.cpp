@@ -1,5 +1,6 @@
 #include "modules/mpd.hpp"
 
+#include <algorithm>
 #include <csignal>
 
 #include "drawtypes/iconset.hpp"
@@ -143,22 +144,54 @@ namespace modules {
   }
 
   void mpd_module::teardown() {
-    m_mpd.reset();
+    if (m_mpd) {
+      m_mpd->interrupt();
+    }
   }
 
   inline bool mpd_module::connected() const {
     return m_mpd && m_mpd->connected();
   }
 
+  /**
+   * Wait for the server to report a change in one of the subsystems or for
+   * the next elapsed time tick
+   */
   void mpd_module::idle() {
-    if (connected()) {
-      m_quick_attempts = 0;
-      sleep(80ms);
-    } else {
+    if (!connected()) {
       sleep(m_quick_attempts++ < 5 ? 0.5s : 2s);
+      return;
+    }
+
+    m_quick_attempts = 0;
+
+    try {
+      m_mpd->idle();
+      m_mpd->wait(next_tick());
+    } catch (const mpd_exception& err) {
+      m_log.err("%s: %s", name(), err.what());
+      std::lock_guard<std::mutex> guard(m_updatelock);
+      m_mpd.reset();
     }
   }
 
+  /**
+   * Time until the elapsed time shown in the bar has to be updated
+   *
+   * A negative value means that there is nothing to update until mpd reports a change.
+   */
+  chrono::milliseconds mpd_module::next_tick() const {
+    if (!(m_label_time || m_bar_progress) || !m_status || !m_status->match_state(mpdstate::PLAYING)) {
+      return chrono::milliseconds{-1};
+    }
+
+    auto next_second = chrono::milliseconds(1000 - m_status->get_elapsed_time_ms() % 1000);
+    auto since_sync = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - m_lastsync);
+    auto next_sync = chrono::milliseconds(static_cast<long>(m_synctime * 1000)) - since_sync;
+
+    return std::max(next_second, next_sync);
+  }
+
   bool mpd_module::has_event() {
     bool def = false;
 
@@ -190,11 +223,13 @@ namespace modules {
     }
 
     try {
-      m_mpd->idle();
+      int idle_flags = m_mpd->recv_idle();
 
-      int idle_flags = 0;
-      if ((idle_flags = m_mpd->noidle()) != 0) {
-        // Update status on every event
+      /*
+       * Only update if either the player state (play, stop, pause, seek, ...), the options (random, repeat, ...),
+       * or the playlist has been changed
+       */
+      if ((idle_flags & (MPD_IDLE_PLAYER | MPD_IDLE_OPTIONS | MPD_IDLE_QUEUE)) != 0 && m_status) {
         m_status->update(idle_flags, m_mpd.get());
         return true;
       }
@@ -204,11 +239,12 @@ namespace modules {
       return def;
     }
 
-    if ((m_label_time || m_bar_progress) && m_status->match_state(mpdstate::PLAYING)) {
+    if ((m_label_time || m_bar_progress) && m_status && m_status->match_state(mpdstate::PLAYING)) {
       auto now = chrono::steady_clock::now();
       auto diff = now - m_lastsync;
 
-      if (chrono::duration_cast<chrono::milliseconds>(diff).count() > m_synctime * 1000) {
+      if (m_status->get_elapsed_time() != m_elapsed_shown &&
+          chrono::duration_cast<chrono::milliseconds>(diff).count() >= m_synctime * 1000) {
         m_lastsync = now;
         return true;
       }
@@ -232,54 +268,55 @@ namespace modules {
       }
     }
 
-    if (m_status && m_status->match_state(mpdstate::PLAYING)) {
-      // Always update the status while playing
-      m_status->update(-1, m_mpd.get());
-    }
-
-    string artist;
-    string album_artist;
-    string album;
-    string title;
-    string date;
-    string elapsed_str;
-    string total_str;
+    bool song_changed = false;
 
     try {
-      if (m_status) {
-        elapsed_str = m_status->get_formatted_elapsed();
-        total_str = m_status->get_formatted_total();
-      }
-
-      if (m_mpd) {
-        auto song = m_mpd->get_song();
-
-        if (song) {
-          artist = song->get_artist();
-          album_artist = song->get_album_artist();
-          album = song->get_album();
-          title = song->get_title();
-          date = song->get_date();
+      if (m_mpd && m_status) {
+        if (!m_song.matches(m_status->get_songid(), m_status->get_queue_version())) {
+          m_song = songinfo{};
+          m_song.id = m_status->get_songid();
+          m_song.queue_version = m_status->get_queue_version();
+
+          auto song = m_mpd->get_song();
+
+          if (song) {
+            m_song.artist = song->get_artist();
+            m_song.album_artist = song->get_album_artist();
+            m_song.album = song->get_album();
+            m_song.title = song->get_title();
+            m_song.date = song->get_date();
+          }
+
+          song_changed = true;
         }
+      } else {
+        m_song = songinfo{};
+        song_changed = true;
       }
     } catch (const mpd_exception& err) {
       m_log.err("%s: %s", name(), err.what());
       m_mpd.reset();
+      m_song = songinfo{};
+      song_changed = true;
     }
 
-    if (m_label_song) {
+    // The song label only has to be touched if the song changed, every other update is a time tick
+    if (m_label_song && song_changed) {
       m_label_song->reset_tokens();
-      m_label_song->replace_token("%artist%", !artist.empty() ? artist : "untitled artist");
-      m_label_song->replace_token("%album-artist%", !album_artist.empty() ? album_artist : "untitled album artist");
-      m_label_song->replace_token("%album%", !album.empty() ? album : "untitled album");
-      m_label_song->replace_token("%title%", !title.empty() ? title : "untitled track");
-      m_label_song->replace_token("%date%", !date.empty() ? date : "unknown date");
+      m_label_song->replace_token("%artist%", !m_song.artist.empty() ? m_song.artist : "untitled artist");
+      m_label_song->replace_token(
+          "%album-artist%", !m_song.album_artist.empty() ? m_song.album_artist : "untitled album artist");
+      m_label_song->replace_token("%album%", !m_song.album.empty() ? m_song.album : "untitled album");
+      m_label_song->replace_token("%title%", !m_song.title.empty() ? m_song.title : "untitled track");
+      m_label_song->replace_token("%date%", !m_song.date.empty() ? m_song.date : "unknown date");
     }
 
+    m_elapsed_shown = m_status ? m_status->get_elapsed_time() : 0U;
+
     if (m_label_time) {
       m_label_time->reset_tokens();
-      m_label_time->replace_token("%elapsed%", elapsed_str);
-      m_label_time->replace_token("%total%", total_str);
+      m_label_time->replace_token("%elapsed%", m_status ? m_status->get_formatted_elapsed() : "");
+      m_label_time->replace_token("%total%", m_status ? m_status->get_formatted_total() : "");
     }
 
     if (m_icons->has("random")) {
@@ -54,19 +54,18 @@ namespace modules {
   }
 
   void pulseaudio_module::teardown() {
-    m_pulseaudio.reset();
+    m_pulseaudio->interrupt();
+  }
+
+  /**
+   * Block until pulseaudio reports a change, there is no need to poll
+   */
+  void pulseaudio_module::idle() {
+    m_pulseaudio->wait();
   }
 
   bool pulseaudio_module::has_event() {
-    // Poll for mixer and control events
-    try {
-      if (m_pulseaudio->wait()) {
-        return true;
-      }
-    } catch (const pulseaudio_error& e) {
-      m_log.err("%s: %s", name(), e.what());
-    }
-    return false;
+    return m_pulseaudio->has_events();
   }
 
   bool pulseaudio_module::update() {
@@ -39,31 +39,122 @@ namespace modules {
   }
 
   /**
-   * Get the title by returning the first non-empty value of:
+   * Mark the cached properties that depend on the given atom as outdated
+   *
+   * @return true if the atom is used by this window
+   */
+  bool active_window::invalidate(xcb_atom_t atom) {
+    if (atom == _NET_WM_NAME || atom == _NET_WM_VISIBLE_NAME || atom == WM_NAME) {
+      m_title_valid = false;
+      return true;
+    } else if (atom == WM_CLASS) {
+      m_class_valid = false;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Fetch all outdated properties
+   *
+   * All requests are sent before waiting for the first reply so that this
+   * only costs a single round-trip.
+   *
+   * The title is the first non-empty value of:
    *  _NET_WM_NAME
    *  _NET_WM_VISIBLE_NAME
    *  WM_NAME
+   *
+   * @return true if any of the cached values changed
    */
-  string active_window::title() const {
-    string title;
-
-    if (!(title = ewmh_util::get_wm_name(m_window)).empty()) {
-      return title;
-    } else if (!(title = ewmh_util::get_visible_name(m_window)).empty()) {
-      return title;
-    } else if (!(title = icccm_util::get_wm_name(m_connection, m_window)).empty()) {
-      return title;
-    } else {
-      return "";
+  bool active_window::refresh() {
+    bool fetch_title = !m_title_valid;
+    bool fetch_class = !m_class_valid;
+
+    if (m_window == XCB_NONE || (!fetch_title && !fetch_class)) {
+      return false;
+    }
+
+    auto& ewmh = ewmh_util::initialize();
+    xcb_get_property_cookie_t net_wm_name_cookie{};
+    xcb_get_property_cookie_t visible_name_cookie{};
+    xcb_get_property_cookie_t wm_name_cookie{};
+    xcb_get_property_cookie_t wm_class_cookie{};
+
+    if (fetch_title) {
+      net_wm_name_cookie = xcb_ewmh_get_wm_name(ewmh, m_window);
+      visible_name_cookie = xcb_ewmh_get_wm_visible_name(ewmh, m_window);
+      wm_name_cookie = xcb_icccm_get_wm_name(m_connection, m_window);
     }
+
+    if (fetch_class) {
+      wm_class_cookie = xcb_icccm_get_wm_class(m_connection, m_window);
+    }
+
+    bool changed = false;
+
+    if (fetch_title) {
+      string net_wm_name;
+      string visible_name;
+      string wm_name;
+
+      xcb_ewmh_get_utf8_strings_reply_t utf8_reply{};
+      if (xcb_ewmh_get_wm_name_reply(ewmh, net_wm_name_cookie, &utf8_reply, nullptr)) {
+        net_wm_name = ewmh_util::get_reply_string(&utf8_reply);
+      }
+      if (xcb_ewmh_get_wm_visible_name_reply(ewmh, visible_name_cookie, &utf8_reply, nullptr)) {
+        visible_name = ewmh_util::get_reply_string(&utf8_reply);
+      }
+
+      xcb_icccm_get_text_property_reply_t text_reply{};
+      if (xcb_icccm_get_wm_name_reply(m_connection, wm_name_cookie, &text_reply, nullptr)) {
+        wm_name = icccm_util::get_reply_string(&text_reply);
+      }
+
+      string title;
+      if (!net_wm_name.empty()) {
+        title = move(net_wm_name);
+      } else if (!visible_name.empty()) {
+        title = move(visible_name);
+      } else {
+        title = move(wm_name);
+      }
+
+      changed = changed || title != m_title;
+      m_title = move(title);
+      m_title_valid = true;
+    }
+
+    if (fetch_class) {
+      string instance_name;
+      string class_name;
+
+      xcb_icccm_get_wm_class_reply_t class_reply{};
+      if (xcb_icccm_get_wm_class_reply(m_connection, wm_class_cookie, &class_reply, nullptr)) {
+        instance_name = class_reply.instance_name;
+        class_name = class_reply.class_name;
+        xcb_icccm_get_wm_class_reply_wipe(&class_reply);
+      }
+
+      changed = changed || instance_name != m_instance_name || class_name != m_class_name;
+      m_instance_name = move(instance_name);
+      m_class_name = move(class_name);
+      m_class_valid = true;
+    }
+
+    return changed;
+  }
+
+  const string& active_window::title() const {
+    return m_title;
   }
 
-  string active_window::instance_name() const {
-    return icccm_util::get_wm_class(m_connection, m_window).first;
+  const string& active_window::instance_name() const {
+    return m_instance_name;
   }
 
-  string active_window::class_name() const {
-    return icccm_util::get_wm_class(m_connection, m_window).second;
+  const string& active_window::class_name() const {
+    return m_class_name;
   }
 
   /**
@@ -86,41 +177,56 @@ namespace modules {
       m_statelabels.emplace(state::ACTIVE, load_optional_label(m_conf, name(), "label", "%title%"));
       m_statelabels.emplace(state::EMPTY, load_optional_label(m_conf, name(), "label-empty", ""));
     }
+
+    // Afterwards, the active window is only queried when _NET_ACTIVE_WINDOW or _NET_CURRENT_DESKTOP change
+    update_active_window();
   }
 
   /**
    * Handler for XCB_PROPERTY_NOTIFY events
    */
   void xwindow_module::handle(const evt::property_notify& evt) {
-    if (evt->atom == _NET_ACTIVE_WINDOW) {
-      reset_active_window();
-      update();
-    } else if (evt->atom == _NET_CURRENT_DESKTOP) {
-      reset_active_window();
-      update();
-    } else if (evt->atom == _NET_WM_NAME || evt->atom == _NET_WM_VISIBLE_NAME || evt->atom == WM_NAME ||
-               evt->atom == WM_CLASS) {
-      update();
-    } else {
+    if (evt->atom == _NET_ACTIVE_WINDOW || evt->atom == _NET_CURRENT_DESKTOP) {
+      if (!update_active_window()) {
+        return;
+      }
+    } else if (!m_active || !m_active->match(evt->window) || !m_active->invalidate(evt->atom)) {
+      return;
+    } else if (!m_active->refresh()) {
+      // Many applications set the same title over and over again
       return;
     }
 
+    update();
     broadcast();
   }
 
-  void xwindow_module::reset_active_window() {
+  /**
+   * Query the currently active window and start tracking it if it changed
+   *
+   * @return true if the active window changed
+   */
+  bool xwindow_module::update_active_window() {
+    xcb_window_t win = ewmh_util::get_active_window();
+
+    if (m_active ? m_active->match(win) : win == XCB_NONE) {
+      return false;
+    }
+
     m_active.reset();
+    if (win != XCB_NONE) {
+      m_active = make_unique<active_window>(m_connection, win);
+    }
+
+    return true;
   }
 
   /**
-   * Update the currently active window and query its title
+   * Update the label from the currently active window
    */
   void xwindow_module::update() {
-    if (!m_active) {
-      xcb_window_t win = ewmh_util::get_active_window();
-      if (win != XCB_NONE) {
-        m_active = make_unique<active_window>(m_connection, win);
-      }
+    if (m_active) {
+      m_active->refresh();
     }
 
     if (!m_statelabels.empty()) {
@@ -6,16 +6,19 @@
 #include <cstdlib>
 #include <cstring>
 #include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
 
 #include "common.hpp"
 #include "components/eventloop.hpp"
+#include "ipc/cmdline.hpp"
 #include "ipc/decoder.hpp"
 #include "ipc/encoder.hpp"
 #include "ipc/msg.hpp"
 #include "ipc/util.hpp"
-#include "modules/ipc.hpp"
-#include "utils/actions.hpp"
 #include "utils/file.hpp"
+#include "utils/string.hpp"
 
 using namespace std;
 using namespace polybar;
@@ -24,6 +27,9 @@ using namespace eventloop;
 static const char* exec = nullptr;
 static constexpr auto USAGE = "<command=(action|cmd)> <payload> [...]";
 static constexpr auto USAGE_HOOK = "hook <module-name> <hook-index>";
+static constexpr auto USAGE_STDIN = "--stdin";
+static constexpr auto USAGE_SUBSCRIBE = "subscribe [event=(output|visibility)]...";
+static constexpr auto USAGE_BATCH = "batch";
 
 void display(const string& msg) {
   fprintf(stdout, "%s\n", msg.c_str());
@@ -41,6 +47,13 @@ void usage(FILE* f, const string& parameters) {
   fprintf(f, "Usage: %s [-p pid] %s\n", exec, parameters.c_str());
 }
 
+void usage_all(FILE* f) {
+  usage(f, USAGE);
+  usage(f, USAGE_STDIN);
+  usage(f, USAGE_SUBSCRIBE);
+  usage(f, USAGE_BATCH);
+}
+
 void remove_socket(const string& handle) {
   if (unlink(handle.c_str()) == -1) {
     error("Could not remove stale ipc channel: "s + strerror(errno));
@@ -49,10 +62,6 @@ void remove_socket(const string& handle) {
   }
 }
 
-bool validate_type(const string& type) {
-  return (type == "action" || type == "cmd" || type == "hook");
-}
-
 static vector<string> get_sockets() {
   auto sockets = file_util::glob(ipc::get_glob_socket_path());
 
@@ -104,77 +113,382 @@ static void on_connection(PipeHandle& conn, ipc::decoder& dec, int pid, const ip
       });
 }
 
-static std::pair<ipc::type_t, string> parse_message(deque<string> args) {
-  // Validate args
-  const string ipc_type{args.front()};
-  args.pop_front();
-  string ipc_payload{args.front()};
-  args.pop_front();
+/**
+ * Creates the message for the given arguments, warns about deprecated hook messages
+ */
+static std::pair<ipc::type_t, string> parse_message(const deque<string>& args) {
+  bool hook = !args.empty() && args.front() == "hook";
+  if (hook && args.size() != 3) {
+    usage(stderr, USAGE_HOOK);
+  }
+
+  auto message = ipc::parse_message(args);
 
-  if (!validate_type(ipc_type)) {
-    error("\"" + ipc_type + "\" is not a valid message type.");
+  if (hook) {
+    fprintf(stderr,
+        "Warning: Using IPC hook commands is deprecated, use the hook action on the ipc module: %s %s \"%s\"\n", exec,
+        "action", message.second.c_str());
   }
 
-  ipc::type_t type = ipc::TYPE_ERR;
+  return message;
+}
 
-  /*
-   * Check hook specific args
+/**
+ * Reads actions from stdin until it is closed
+ *
+ * Every line uses the same arguments as the action message on the command line.
+ *
+ * @returns The payload of a batch message
+ */
+static string read_batch() {
+  vector<string> actions;
+  string line;
+
+  while (std::getline(std::cin, line)) {
+    if (string_util::trim(string{line}).empty()) {
+      continue;
+    }
+
+    auto args = ipc::split_line(line);
+    if (args.empty() || args.front() != "action") {
+      error("Batches may only contain actions, got '" + line + "'");
+    }
+
+    actions.emplace_back(parse_message(args).second);
+  }
+
+  if (actions.empty()) {
+    error("No actions read from stdin");
+  }
+
+  return ipc::encode_batch(actions);
+}
+
+/**
+ * Connection to a single polybar process that is kept open for multiple messages
+ */
+struct channel {
+  using cb = std::function<void(channel&, ipc::type_t, const vector<uint8_t>&)>;
+
+  channel(loop& loop, string path, const logger& logger, cb callback)
+      : pid(ipc::get_pid_from_socket(path))
+      , path(move(path))
+      , conn(loop.handle<PipeHandle>())
+      , dec(logger, [this, callback](uint8_t, ipc::type_t type, const auto& msg) { callback(*this, type, msg); }) {}
+
+  /**
+   * Sends the message right away or once the connection is established
    *
-   * The hook type is deprecated. Its contents are translated into a hook action.
+   * The description is used to report the response to this message.
    */
-  if (ipc_type == "hook") {
-    if (args.size() != 1) {
-      usage(stderr, USAGE_HOOK);
-      throw std::runtime_error("Mismatched number of arguments for hook, expected 1, got "s + to_string(args.size()));
-    } else {
-      if (ipc_payload.find("module/") == 0) {
-        ipc_payload.erase(0, strlen("module/"));
-      }
+  void send(ipc::type_t type, const string& payload, string description, bool& success) {
+    if (closed) {
+      return;
+    }
+
+    pending.push_back(move(description));
+    auto data = make_shared<vector<uint8_t>>(ipc::encode(type, payload));
 
-      // Hook commands use 1-indexed hooks but actions use 0-indexed ones
-      int hook_index = std::stoi(args.front()) - 1;
-      args.pop_front();
+    if (!connected) {
+      queued.push_back(data);
+      return;
+    }
 
-      type = to_integral(ipc::v0::ipc_type::ACTION);
-      ipc_payload =
-          actions_util::get_action_string(ipc_payload, polybar::modules::ipc_module::EVENT_HOOK, to_string(hook_index));
+    conn->write(
+        *data, [data]() {},
+        [this, data, &success](const auto& e) {
+          uv_error(e.status, pid, "There was an error while sending the IPC message.");
+          success = false;
+          close();
+        });
+  }
 
-      fprintf(stderr,
-          "Warning: Using IPC hook commands is deprecated, use the hook action on the ipc module: %s %s \"%s\"\n", exec,
-          "action", ipc_payload.c_str());
+  void close() {
+    if (!closed) {
+      closed = true;
+      conn->close();
     }
   }
 
-  if (ipc_type == "action") {
-    type = to_integral(ipc::v0::ipc_type::ACTION);
-    /**
-     * Alternatively polybar-msg action <module name> <action> <data>
-     * is also accepted
-     */
-    if (!args.empty()) {
-      string name = ipc_payload;
-      string action = args.front();
-      args.pop_front();
-      string data{};
-      if (!args.empty()) {
-        data = args.front();
-        args.pop_front();
+  int pid;
+  string path;
+  pipe_handle_t conn;
+  ipc::decoder dec;
+  bool connected{false};
+  bool closed{false};
+
+  /**
+   * Descriptions of the sent messages that were not answered yet, in order
+   */
+  deque<string> pending;
+
+  /**
+   * Messages sent before the connection was established
+   */
+  vector<shared_ptr<vector<uint8_t>>> queued;
+};
+
+/**
+ * Connects the channel, sends all queued messages and calls on_eof once polybar closes the connection
+ */
+static void connect_channel(channel& c, bool& success, std::function<void(channel&)> on_eof) {
+  c.conn->connect(
+      c.path,
+      [&c, &success, on_eof]() {
+        c.connected = true;
+
+        for (auto&& data : c.queued) {
+          c.conn->write(
+              *data, [data]() {},
+              [&c, data, &success](const auto& e) {
+                uv_error(e.status, c.pid, "There was an error while sending the IPC message.");
+                success = false;
+                c.close();
+              });
+        }
+        c.queued.clear();
+
+        c.conn->read_start(
+            [&c](const auto& e) {
+              try {
+                if (!c.dec.closed()) {
+                  c.dec.on_read(reinterpret_cast<const uint8_t*>(e.data), e.len);
+                }
+              } catch (const ipc::decoder::error& err) {
+                fprintf(stderr, "%s: Invalid response from PID %d (reason: %s)\n", exec, c.pid, err.what());
+                c.close();
+              }
+            },
+            [&c, on_eof]() { on_eof(c); },
+            [&c, &success](const auto& e) {
+              uv_error(e.status, c.pid, "There was an error while reading polybar's response");
+              success = false;
+              c.close();
+            });
+      },
+      [&c, &success](const auto& e) {
+        fprintf(stderr, "%s: Failed to connect to '%s' (err: '%s')\n", exec, c.path.c_str(), uv_strerror(e.status));
+        success = false;
+        c.closed = true;
+      });
+}
+
+/**
+ * Lines read from stdin, shared with the reader thread
+ */
+struct stdin_lines {
+  std::mutex mutex;
+  deque<string> lines;
+  bool eof{false};
+  /**
+   * Set once the async handle is closed, the reader thread must not use it anymore
+   */
+  bool closed{false};
+};
+
+/**
+ * Sends every line read from stdin as a message to all polybar processes
+ *
+ * A single connection is kept open to each process. Responses are printed as they arrive and the connections are
+ * closed once stdin is closed and all messages were answered.
+ */
+static bool run_session(const vector<string>& sockets) {
+  bool success = true;
+  loop loop;
+  logger null_logger{loglevel::NONE};
+  vector<unique_ptr<channel>> channels;
+  bool input_done = false;
+
+  auto finish_if_done = [&input_done](channel& c) {
+    if (input_done && c.pending.empty()) {
+      c.close();
+    }
+  };
+
+  for (auto&& path : sockets) {
+    channels.emplace_back(make_unique<channel>(
+        loop, path, null_logger, [&success, &finish_if_done](channel& c, ipc::type_t type, const auto& response) {
+          string description;
+          if (!c.pending.empty()) {
+            description = move(c.pending.front());
+            c.pending.pop_front();
+          }
+
+          switch (type) {
+            case ipc::TYPE_OK:
+              if (!description.empty()) {
+                printf("Successfully wrote %s to PID %d\n", description.c_str(), c.pid);
+              }
+              break;
+            case ipc::TYPE_ERR: {
+              string err_str{response.begin(), response.end()};
+              fprintf(stderr, "%s: Failed to write %s to PID %d (reason: %s)\n", exec,
+                  description.empty() ? "session request" : description.c_str(), c.pid, err_str.c_str());
+              success = false;
+              break;
+            }
+            default:
+              fprintf(stderr, "%s: Got back unrecognized message type %d from PID %d\n", exec, type, c.pid);
+              success = false;
+              break;
+          }
+
+          fflush(stdout);
+          finish_if_done(c);
+        }));
+
+    auto& c = *channels.back();
+    c.send(to_integral(ipc::v0::ipc_type::SESSION), "", "", success);
+    connect_channel(c, success, [&success](channel& c) {
+      if (!c.pending.empty()) {
+        fprintf(stderr, "%s: PID %d closed the connection before answering %zu messages\n", exec, c.pid,
+            c.pending.size());
+        success = false;
       }
+      c.close();
+    });
+  }
 
-      ipc_payload = actions_util::get_action_string(name, action, data);
+  auto input = make_shared<stdin_lines>();
+  auto async = loop.handle<AsyncHandle>([&, input]() {
+    deque<string> lines;
+    bool eof;
+    {
+      std::lock_guard<std::mutex> guard(input->mutex);
+      std::swap(lines, input->lines);
+      eof = input->eof;
+    }
+
+    for (auto&& line : lines) {
+      if (string_util::trim(string{line}).empty()) {
+        continue;
+      }
+
+      try {
+        string payload;
+        ipc::type_t type;
+        std::tie(type, payload) = parse_message(ipc::split_line(line));
+        string description =
+            (type == to_integral(ipc::v0::ipc_type::ACTION) ? "action '" : "command '") + payload + "'";
+
+        for (auto&& c : channels) {
+          c->send(type, payload, description, success);
+        }
+      } catch (const std::exception& e) {
+        fprintf(stderr, "%s: Invalid message '%s' (reason: %s)\n", exec, line.c_str(), e.what());
+        success = false;
+      }
+    }
+
+    if (eof) {
+      input_done = true;
+      for (auto&& c : channels) {
+        finish_if_done(*c);
+      }
+    }
+  });
+
+  /*
+   * Reads stdin on a separate thread because libuv can't poll stdin if it is a regular file.
+   * The thread is detached because it may still block on stdin when all connections are closed.
+   */
+  std::thread([input, &handle = *async]() {
+    string line;
+    bool eof = false;
+    while (!eof) {
+      eof = !std::getline(std::cin, line);
+
+      std::lock_guard<std::mutex> guard(input->mutex);
+      if (input->closed) {
+        return;
+      }
+      if (eof) {
+        input->eof = true;
+      } else {
+        input->lines.push_back(move(line));
+      }
+      handle.send();
+    }
+  }).detach();
+
+  /*
+   * The async handle keeps the eventloop running, close it once all connections are closed.
+   */
+  auto check = loop.handle<PrepareHandle>();
+  check->start([&, input, &async_handle = *async, &check_handle = *check]() {
+    if (std::all_of(channels.begin(), channels.end(), [](const auto& c) { return c->closed; })) {
+      {
+        std::lock_guard<std::mutex> guard(input->mutex);
+        input->closed = true;
+      }
+      async_handle.close();
+      check_handle.close();
+    }
+  });
+
+  try {
+    loop.run();
+  } catch (const exception& e) {
+    throw std::runtime_error("Uncaught exception in eventloop: "s + e.what());
+  }
+
+  return success;
+}
+
+/**
+ * Prints the events of all polybar processes until they close the connection
+ */
+static bool run_subscribe(const vector<string>& sockets, const deque<string>& events) {
+  for (auto&& event : events) {
+    if (event != ipc::v0::EVENT_OUTPUT && event != ipc::v0::EVENT_VISIBILITY) {
+      usage(stderr, USAGE_SUBSCRIBE);
+      error("\"" + event + "\" is not a valid event.");
     }
   }
 
-  if (ipc_type == "cmd") {
-    type = to_integral(ipc::v0::ipc_type::CMD);
+  string payload = string_util::join({events.begin(), events.end()}, " ");
+  bool success = true;
+  loop loop;
+  logger null_logger{loglevel::NONE};
+  vector<unique_ptr<channel>> channels;
+
+  for (auto&& path : sockets) {
+    channels.emplace_back(
+        make_unique<channel>(loop, path, null_logger, [&success](channel& c, ipc::type_t type, const auto& response) {
+          string data{response.begin(), response.end()};
+
+          switch (type) {
+            case ipc::TYPE_OK:
+              c.pending.clear();
+              break;
+            case ipc::v0::TYPE_EVENT:
+              printf("%d %s\n", c.pid, data.c_str());
+              fflush(stdout);
+              break;
+            case ipc::TYPE_ERR:
+              fprintf(stderr, "%s: Failed to subscribe to PID %d (reason: %s)\n", exec, c.pid, data.c_str());
+              success = false;
+              c.close();
+              break;
+            default:
+              fprintf(stderr, "%s: Got back unrecognized message type %d from PID %d\n", exec, type, c.pid);
+              success = false;
+              break;
+          }
+        }));
+
+    auto& c = *channels.back();
+    c.send(to_integral(ipc::v0::ipc_type::SUBSCRIBE), payload, "", success);
+    connect_channel(c, success, [](channel& c) { c.close(); });
   }
 
-  if (!args.empty()) {
-    error("Too many arguments");
+  try {
+    loop.run();
+  } catch (const exception& e) {
+    throw std::runtime_error("Uncaught exception in eventloop: "s + e.what());
   }
 
-  assert(type != ipc::TYPE_ERR);
-  return {type, ipc_payload};
+  return success;
 }
 
 int run(int argc, char** argv) {
@@ -184,7 +498,7 @@ int run(int argc, char** argv) {
 
   auto help_pos = find_if(args.begin(), args.end(), [](const string& a) { return a == "-h" || a == "--help"; });
   if (help_pos != args.end()) {
-    usage(stdout, USAGE);
+    usage_all(stdout);
     return EXIT_SUCCESS;
   }
 
@@ -212,15 +526,39 @@ int run(int argc, char** argv) {
     error("No active ipc channels");
   }
 
-  if (args.size() < 2) {
-    usage(stderr, USAGE);
-    return EXIT_FAILURE;
+  if (!args.empty() && args.front() == USAGE_STDIN) {
+    if (args.size() != 1) {
+      usage(stderr, USAGE_STDIN);
+      return EXIT_FAILURE;
+    }
+    return run_session(sockets) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if (!args.empty() && args.front() == "subscribe") {
+    args.pop_front();
+    return run_subscribe(sockets, args) ? EXIT_SUCCESS : EXIT_FAILURE;
   }
 
   string payload;
   ipc::type_t type;
-  std::tie(type, payload) = parse_message(args);
-  string type_str = type == to_integral(ipc::v0::ipc_type::ACTION) ? "action" : "command";
+  /*
+   * Describes the message in the success and error messages
+   */
+  string description;
+
+  if (args.size() == 1 && args.front() == "batch") {
+    payload = read_batch();
+    type = to_integral(ipc::v0::ipc_type::BATCH);
+    auto count = std::count(payload.begin(), payload.end(), '\n') + 1;
+    description = "batch of " + to_string(count) + " actions";
+  } else if (args.size() < 2) {
+    usage_all(stderr);
+    return EXIT_FAILURE;
+  } else {
+    std::tie(type, payload) = parse_message(args);
+    string type_str = type == to_integral(ipc::v0::ipc_type::ACTION) ? "action" : "command";
+    description = type_str + " '" + payload + "'";
+  }
 
   bool success = true;
 
@@ -238,15 +576,15 @@ int run(int argc, char** argv) {
     assert(pid > 0);
 
     decoders.emplace_back(
-        null_logger, [pid, channel, &payload, &type_str, &success](uint8_t, ipc::type_t type, const auto& response) {
+        null_logger, [pid, channel, &description, &success](uint8_t, ipc::type_t type, const auto& response) {
           switch (type) {
             case ipc::TYPE_OK:
-              printf("Successfully wrote %s '%s' to PID %d\n", type_str.c_str(), payload.c_str(), pid);
+              printf("Successfully wrote %s to PID %d\n", description.c_str(), pid);
               break;
             case ipc::TYPE_ERR: {
               string err_str{response.begin(), response.end()};
-              fprintf(stderr, "%s: Failed to write %s '%s' to PID %d (reason: %s)\n", exec, type_str.c_str(),
-                  payload.c_str(), pid, err_str.c_str());
+              fprintf(stderr, "%s: Failed to write %s to PID %d (reason: %s)\n", exec, description.c_str(), pid,
+                  err_str.c_str());
               success = false;
               break;
             }
@@ -44,13 +44,15 @@ void print_build_info(bool extended) {
     (ENABLE_XKEYBOARD  ? '+' : '-'));
   if (extended) {
     printf("\n");
-    printf("X extensions: %crandr (%cmonitors) %ccomposite %cxkb %cxrm %cxcursor\n",
+    printf("X extensions: %crandr (%cmonitors) %ccomposite %cxkb %cxrm %cxcursor %cxshm %cxpresent\n",
       (WITH_XRANDR            ? '+' : '-'),
       (WITH_XRANDR_MONITORS   ? '+' : '-'),
       (WITH_XCOMPOSITE        ? '+' : '-'),
       (WITH_XKB               ? '+' : '-'),
       (WITH_XRM               ? '+' : '-'),
-      (WITH_XCURSOR           ? '+' : '-'));
+      (WITH_XCURSOR           ? '+' : '-'),
+      (WITH_XSHM              ? '+' : '-'),
+      (WITH_XPRESENT          ? '+' : '-'));
     printf("\n");
     printf("Build type: @CMAKE_BUILD_TYPE@\n");
     printf("Compiler: @CMAKE_CXX_COMPILER@\n");
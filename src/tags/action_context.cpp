@@ -1,5 +1,6 @@
 #include "tags/action_context.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 POLYBAR_NS
@@ -8,9 +9,12 @@ namespace tags {
 
   void action_context::reset() {
     m_action_blocks.clear();
+    m_spans.clear();
+    m_index_valid = false;
   }
 
   action_t action_context::action_open(mousebtn btn, const string&& cmd, alignment align, double x) {
+    m_index_valid = false;
     action_t id = m_action_blocks.size();
     m_action_blocks.emplace_back(std::move(cmd), btn, align, true);
     set_start(id, x);
@@ -21,6 +25,7 @@ namespace tags {
     for (auto it = m_action_blocks.rbegin(); it != m_action_blocks.rend(); it++) {
       if (it->is_open && it->align == align && (btn == mousebtn::NONE || it->button == btn)) {
         it->is_open = false;
+        m_index_valid = false;
 
         // Converts a reverse iterator into an index
         action_t id = std::distance(m_action_blocks.begin(), it.base()) - 1;
@@ -46,6 +51,7 @@ namespace tags {
 
   void action_context::compensate_for_negative_move(alignment a, double old_x, double new_x) {
     assert(new_x < old_x);
+    m_index_valid = false;
     for (auto& block : m_action_blocks) {
       if (block.is_open && block.align == a) {
         // Move back the start position if a smaller position is observed
@@ -63,30 +69,118 @@ namespace tags {
 
   void action_context::set_alignment_start(const alignment a, const double x) {
     m_align_start[a] = x;
+    m_index_valid = false;
+  }
+
+  void action_context::build_index() {
+    m_spans.clear();
+
+    /*
+     * Absolute [start, end) coordinates of all action blocks, same rounding as action_block::test
+     */
+    std::vector<std::pair<int, int>> bounds;
+    bounds.reserve(m_action_blocks.size());
+
+    std::vector<int> points;
+    points.reserve(2 * m_action_blocks.size());
+
+    for (const auto& block : m_action_blocks) {
+      double align_start = m_align_start.at(block.align);
+      int start = static_cast<int>(block.start_x + align_start);
+      int end = static_cast<int>(block.end_x + align_start);
+      bounds.emplace_back(start, end);
+
+      if (start < end) {
+        points.push_back(start);
+        points.push_back(end);
+      }
+    }
+
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    m_spans.reserve(points.size());
+    for (int start : points) {
+      action_span span{start, 0, {}};
+      span.ids.fill(NO_ACTION);
+      m_spans.push_back(span);
+    }
+
+    // Higher IDs are higher in the action stack, so they overwrite lower ones.
+    for (action_t id = 0; (unsigned)id < m_action_blocks.size(); id++) {
+      int start = bounds[id].first;
+      int end = bounds[id].second;
+
+      if (start >= end) {
+        continue;
+      }
+
+      auto btn = m_action_blocks[id].button;
+      auto it = std::lower_bound(points.begin(), points.end(), start);
+
+      for (auto i = std::distance(points.begin(), it); points[i] < end; i++) {
+        m_spans[i].ids[static_cast<size_t>(btn)] = id;
+        m_spans[i].mask |= make_btn_mask({btn});
+      }
+    }
+
+    m_index_valid = true;
+  }
+
+  const action_context::action_span* action_context::find_span(int x) const {
+    auto it = std::upper_bound(
+        m_spans.begin(), m_spans.end(), x, [](int x, const action_span& span) { return x < span.start; });
+
+    if (it == m_spans.begin()) {
+      return nullptr;
+    }
+
+    return &*std::prev(it);
   }
 
   std::map<mousebtn, tags::action_t> action_context::get_actions(int x) const {
     std::map<mousebtn, tags::action_t> buttons;
 
     for (int i = static_cast<int>(mousebtn::NONE); i < static_cast<int>(mousebtn::BTN_COUNT); i++) {
-      buttons[static_cast<mousebtn>(i)] = tags::NO_ACTION;
+      buttons[static_cast<mousebtn>(i)] = has_action(static_cast<mousebtn>(i), x);
+    }
+
+    return buttons;
+  }
+
+  action_t action_context::has_action(mousebtn btn, int x) const {
+    if (m_index_valid) {
+      const auto* span = find_span(x);
+      return span ? span->ids[static_cast<size_t>(btn)] : NO_ACTION;
     }
 
+    action_t result = NO_ACTION;
+
+    // Higher IDs are higher in the action stack.
     for (action_t id = 0; (unsigned)id < m_action_blocks.size(); id++) {
-      auto action = m_action_blocks[id];
-      mousebtn btn = action.button;
+      const auto& action = m_action_blocks[id];
 
-      // Higher IDs are higher in the action stack.
-      if (id > buttons[btn] && action.test(m_align_start.at(action.align), x)) {
-        buttons[action.button] = id;
+      if (action.button == btn && action.test(m_align_start.at(action.align), x)) {
+        result = id;
       }
     }
 
-    return buttons;
+    return result;
   }
 
-  action_t action_context::has_action(mousebtn btn, int x) const {
-    return get_actions(x)[btn];
+  bool action_context::has_any_action(btn_mask buttons, int x) const {
+    if (m_index_valid) {
+      const auto* span = find_span(x);
+      return span && (span->mask & buttons) != 0;
+    }
+
+    for (const auto& action : m_action_blocks) {
+      if ((make_btn_mask({action.button}) & buttons) != 0 && action.test(m_align_start.at(action.align), x)) {
+        return true;
+      }
+    }
+
+    return false;
   }
 
   string action_context::get_action(action_t id) const {
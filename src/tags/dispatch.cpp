@@ -28,6 +28,13 @@ namespace tags {
    * Process input string
    */
   void dispatch::parse(const bar_settings& bar, renderer_interface& renderer, const string&& data) {
+    parse(bar, renderer, std::make_shared<const string>(data));
+  }
+
+  /**
+   * Parses the shared buffer directly, the string is not copied
+   */
+  void dispatch::parse(const bar_settings& bar, renderer_interface& renderer, shared_ptr<const string> data) {
     tags::parser p;
     p.set(std::move(data));
 
@@ -114,6 +121,7 @@ namespace tags {
     for (auto a : {alignment::LEFT, alignment::CENTER, alignment::RIGHT}) {
       m_action_ctxt.set_alignment_start(a, renderer.get_alignment_start(a));
     }
+    m_action_ctxt.build_index();
     renderer.apply_tray_position(*m_ctxt);
 
     auto num_unclosed = m_action_ctxt.num_unclosed();
@@ -23,7 +23,7 @@ namespace tags {
     }
 
     if (buf_pos >= buf.size()) {
-      throw std::runtime_error("tag parser: No next element. THIS IS A BUG. (Context: '" + input + "')");
+      throw std::runtime_error("tag parser: No next element. THIS IS A BUG. (Context: '" + *input + "')");
     }
 
     element e = buf[buf_pos];
@@ -88,12 +88,16 @@ namespace tags {
         }
       }
     } catch (error& e) {
-      e.set_context(input.substr(start_pos, pos - start_pos));
+      e.set_context(input->substr(start_pos, pos - start_pos));
       throw;
     }
   }
 
   void parser::set(const string&& input) {
+    set(std::make_shared<const string>(input));
+  }
+
+  void parser::set(shared_ptr<const string> input) {
     this->input = std::move(input);
     pos = 0;
     buf.clear();
@@ -101,7 +105,7 @@ namespace tags {
   }
 
   bool parser::has_next() const {
-    return pos < input.size();
+    return pos < input->size();
   }
 
   char parser::next() {
@@ -115,7 +119,7 @@ namespace tags {
       return EOL;
     }
 
-    return input[pos];
+    return (*input)[pos];
   }
 
   /**
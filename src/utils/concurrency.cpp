@@ -1,5 +1,8 @@
 #include "utils/concurrency.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <map>
 
 POLYBAR_NS
@@ -14,6 +17,138 @@ namespace concurrency_util {
     }
     return ids[id];
   }
+
+  void parallel_for(size_t count, const function<void(size_t)>& fn, size_t max_threads) {
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    mutex error_mutex;
+
+    auto worker = [&] {
+      for (size_t i = next++; i < count; i = next++) {
+        try {
+          fn(i);
+        } catch (...) {
+          std::lock_guard<mutex> guard(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+    };
+
+    size_t num_threads = std::min<size_t>({count, max_threads, std::max(thread::hardware_concurrency(), 1U)});
+
+    vector<thread> threads;
+    for (size_t i = 1; i < num_threads; i++) {
+      threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto&& t : threads) {
+      t.join();
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  worker_pool::worker_pool(size_t num_threads) {
+    for (size_t i = 1; i < num_threads; i++) {
+      m_threads.emplace_back(&worker_pool::work, this);
+    }
+  }
+
+  worker_pool::~worker_pool() {
+    {
+      std::lock_guard<mutex> guard(m_mutex);
+      m_stopped = true;
+    }
+    m_started.notify_all();
+
+    for (auto&& t : m_threads) {
+      t.join();
+    }
+  }
+
+  size_t worker_pool::size() const {
+    return m_threads.size() + 1;
+  }
+
+  void worker_pool::run(size_t count, const function<void(size_t)>& fn) {
+    if (count == 0) {
+      return;
+    }
+
+    std::unique_lock<mutex> guard(m_mutex);
+    m_job = &fn;
+    m_job_id++;
+    m_count = count;
+    m_next = 0;
+    m_remaining = count;
+    m_error = nullptr;
+    guard.unlock();
+
+    m_started.notify_all();
+
+    guard.lock();
+    work_on_job(guard);
+    m_finished.wait(guard, [&] { return m_remaining == 0; });
+
+    m_job = nullptr;
+    auto error = std::move(m_error);
+    guard.unlock();
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  void worker_pool::work() {
+    std::unique_lock<mutex> guard(m_mutex);
+    size_t last_job{0};
+
+    while (true) {
+      m_started.wait(guard, [&] { return m_stopped || m_job_id != last_job; });
+
+      if (m_stopped) {
+        return;
+      }
+
+      last_job = m_job_id;
+      work_on_job(guard);
+    }
+  }
+
+  /**
+   * Takes calls of the current job until none are left
+   *
+   * The lock is only released while fn is called.
+   */
+  void worker_pool::work_on_job(std::unique_lock<mutex>& guard) {
+    while (m_next < m_count) {
+      size_t i = m_next++;
+      const auto& fn = *m_job;
+      guard.unlock();
+
+      std::exception_ptr error;
+      try {
+        fn(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      guard.lock();
+      if (error && !m_error) {
+        m_error = error;
+      }
+
+      if (--m_remaining == 0) {
+        m_finished.notify_one();
+      }
+    }
+  }
 }  // namespace concurrency_util
 
 POLYBAR_NS_END
@@ -250,7 +250,7 @@ void bg_slice::copy(xcb_pixmap_t root_pixmap, int depth, xcb_rectangle_t geom, x
   // fill the slice
   m_log.trace(
       "background_manager: Copying from root pixmap (0x%x:%d) %dx%d+%d+%d", root_pixmap, depth, w, h, src_x, src_y);
-  m_connection.copy_area_checked(root_pixmap, m_pixmap, m_gcontext, src_x, src_y, 0, 0, w, h);
+  m_connection.copy_area(root_pixmap, m_pixmap, m_gcontext, src_x, src_y, 0, 0, w, h);
 }
 
 void bg_slice::ensure_resources(int depth, xcb_visualtype_t* visual) {
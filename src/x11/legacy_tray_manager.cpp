@@ -1146,12 +1146,17 @@ void tray_manager::handle(const evt::unmap_notify& evt) {
  * toggle the tray window whenever the visibility of the bar window changes.
  */
 bool tray_manager::on(const signals::ui::visibility_change& evt) {
-  return change_visibility(evt.cast());
+  auto [window, visible] = evt.cast();
+  if (window != m_bar_opts.x_data.window) {
+    return false;
+  }
+  return change_visibility(visible);
 }
 
 bool tray_manager::on(const signals::ui::dim_window& evt) {
-  if (m_activated) {
-    ewmh_util::set_wm_window_opacity(m_tray, evt.cast() * 0xFFFFFFFF);
+  auto [window, opacity] = evt.cast();
+  if (m_activated && window == m_bar_opts.x_data.window) {
+    ewmh_util::set_wm_window_opacity(m_tray, opacity * 0xFFFFFFFF);
   }
   // let the event bubble
   return false;
@@ -1164,8 +1169,12 @@ bool tray_manager::on(const signals::ui::update_background&) {
 }
 
 bool tray_manager::on(const signals::ui_tray::tray_pos_change& evt) {
-  m_opts.orig_x =
-      m_bar_opts.inner_area(true).x + std::max(0, std::min(evt.cast(), (int)(m_bar_opts.size.w - calculate_w())));
+  auto [window, x] = evt.cast();
+  if (window != m_bar_opts.x_data.window) {
+    return false;
+  }
+
+  m_opts.orig_x = m_bar_opts.inner_area(true).x + std::max(0, std::min(x, (int)(m_bar_opts.size.w - calculate_w())));
 
   reconfigure_window();
 
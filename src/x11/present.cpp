@@ -0,0 +1,97 @@
+#include "x11/present.hpp"
+
+#include "components/logger.hpp"
+#include "x11/connection.hpp"
+
+POLYBAR_NS
+
+unique_ptr<present_window> present_window::make(connection& conn, const logger& log, xcb_window_t window) {
+  const xcb_query_extension_reply_t* ext = xcb_get_extension_data(conn, &xcb_present_id);
+  if (ext == nullptr || !ext->present) {
+    log.warn("present: The X server does not support the Present extension, frames are not synchronized");
+    return nullptr;
+  }
+
+  auto* version = xcb_present_query_version_reply(
+      conn, xcb_present_query_version(conn, XCB_PRESENT_MAJOR_VERSION, XCB_PRESENT_MINOR_VERSION), nullptr);
+  if (version == nullptr) {
+    log.warn("present: Failed to query the version of the Present extension");
+    return nullptr;
+  }
+  log.info("present: Using Present extension %u.%u", version->major_version, version->minor_version);
+  free(version);
+
+  uint32_t eid = xcb_generate_id(conn);
+  xcb_present_select_input(conn, eid, window, XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY);
+
+  return unique_ptr<present_window>(new present_window(conn, log, window, ext->major_opcode, eid));
+}
+
+present_window::present_window(
+    connection& conn, const logger& log, xcb_window_t window, uint8_t opcode, uint32_t eid)
+    : m_connection(conn), m_log(log), m_window(window), m_opcode(opcode), m_eid(eid) {}
+
+present_window::~present_window() {
+  if (m_frames > 0) {
+    m_log.info("present: Showed %zu frames, average latency %.2f ms", m_frames,
+        m_total_latency.count() / 1000.0 / m_frames);
+  }
+}
+
+void present_window::present(xcb_pixmap_t pixmap) {
+  /*
+   * Copy mode keeps the pixmap out of the window's buffer chain, the pixmap is free again once the frame completed.
+   * A target msc of 0 shows the frame at the next vertical blank.
+   */
+  xcb_present_pixmap(m_connection, m_window, pixmap, ++m_serial, XCB_NONE, XCB_NONE, 0, 0, XCB_NONE, XCB_NONE,
+      XCB_NONE, XCB_PRESENT_OPTION_COPY, 0, 0, 0, 0, nullptr);
+  m_pending = true;
+  m_submitted = clock::now();
+}
+
+bool present_window::pending() {
+  if (m_pending && clock::now() - m_submitted > FRAME_TIMEOUT) {
+    m_log.warn("present: Frame %u was not shown after %lld ms, dropping it", m_serial,
+        static_cast<long long>(FRAME_TIMEOUT.count()));
+    m_pending = false;
+  }
+
+  return m_pending;
+}
+
+bool present_window::handle(const xcb_generic_event_t* evt) {
+  if ((evt->response_type & ~0x80) != XCB_GE_GENERIC) {
+    return false;
+  }
+
+  auto* ge = reinterpret_cast<const xcb_ge_generic_event_t*>(evt);
+  if (ge->extension != m_opcode || ge->event_type != XCB_PRESENT_COMPLETE_NOTIFY) {
+    return false;
+  }
+
+  auto* complete = reinterpret_cast<const xcb_present_complete_notify_event_t*>(evt);
+  if (complete->event != m_eid || complete->kind != XCB_PRESENT_COMPLETE_KIND_PIXMAP) {
+    return false;
+  }
+
+  if (complete->serial != m_serial) {
+    // Completion of a frame that already timed out
+    return true;
+  }
+
+  /*
+   * The timestamp is in microseconds of CLOCK_MONOTONIC, which is what the steady clock uses on Linux
+   */
+  auto submitted = std::chrono::duration_cast<std::chrono::microseconds>(m_submitted.time_since_epoch());
+  auto latency = std::chrono::microseconds(complete->ust) - submitted;
+
+  m_log.trace("present: Frame %u shown at msc %llu, %lld us after it was submitted (mode: %u)", complete->serial,
+      static_cast<unsigned long long>(complete->msc), static_cast<long long>(latency.count()), complete->mode);
+
+  m_frames++;
+  m_total_latency += latency;
+  m_pending = false;
+  return true;
+}
+
+POLYBAR_NS_END
@@ -0,0 +1,161 @@
+#include "x11/shm.hpp"
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "components/logger.hpp"
+#include "x11/connection.hpp"
+
+POLYBAR_NS
+
+/**
+ * Checks whether ZPixmap images of the given depth use the memory layout of the cairo image formats
+ *
+ * Those are 32 bits per pixel in native byte order with the color channels at fixed positions.
+ */
+static bool matches_cairo_format(connection& conn, const xcb_visualtype_t* visual, uint8_t depth) {
+  if (depth != 24 && depth != 32) {
+    return false;
+  }
+
+  if (visual->red_mask != 0xff0000 || visual->green_mask != 0xff00 || visual->blue_mask != 0xff) {
+    return false;
+  }
+
+  const uint16_t probe{1};
+  bool little_endian = *reinterpret_cast<const uint8_t*>(&probe) == 1;
+  const xcb_setup_t* setup = xcb_get_setup(conn);
+  if ((setup->image_byte_order == XCB_IMAGE_ORDER_LSB_FIRST) != little_endian) {
+    return false;
+  }
+
+  auto formats = xcb_setup_pixmap_formats_iterator(setup);
+  for (; formats.rem; xcb_format_next(&formats)) {
+    if (formats.data->depth == depth) {
+      return formats.data->bits_per_pixel == 32;
+    }
+  }
+
+  return false;
+}
+
+unique_ptr<shm_image> shm_image::make(
+    connection& conn, const logger& log, const xcb_visualtype_t* visual, uint8_t depth, uint16_t w, uint16_t h) {
+  const xcb_query_extension_reply_t* ext = xcb_get_extension_data(conn, &xcb_shm_id);
+  if (ext == nullptr || !ext->present) {
+    log.info("shm: MIT-SHM is not supported by the X server");
+    return nullptr;
+  }
+
+  if (!matches_cairo_format(conn, visual, depth)) {
+    log.info("shm: Pixel format of the X server is not supported");
+    return nullptr;
+  }
+
+  size_t size = static_cast<size_t>(w) * h * 4;
+  int id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+  if (id == -1) {
+    log.warn("shm: Failed to allocate shared memory segment (%s)", strerror(errno));
+    return nullptr;
+  }
+
+  void* data = shmat(id, nullptr, 0);
+  if (data == reinterpret_cast<void*>(-1)) {
+    log.warn("shm: Failed to attach shared memory segment (%s)", strerror(errno));
+    shmctl(id, IPC_RMID, nullptr);
+    return nullptr;
+  }
+
+  xcb_shm_seg_t seg = xcb_generate_id(conn);
+  xcb_generic_error_t* err = xcb_request_check(conn, xcb_shm_attach_checked(conn, seg, id, false));
+
+  // The segment is removed once both sides detached from it, also if polybar crashes
+  shmctl(id, IPC_RMID, nullptr);
+
+  if (err != nullptr) {
+    // Happens if the X server runs on another machine
+    log.info("shm: X server failed to attach shared memory segment (error %d)", err->error_code);
+    free(err);
+    shmdt(data);
+    return nullptr;
+  }
+
+  log.trace("shm: Attached %zu byte segment 0x%x", size, seg);
+  return unique_ptr<shm_image>(
+      new shm_image(conn, seg, static_cast<unsigned char*>(data), ext->first_event, depth, w, h));
+}
+
+shm_image::shm_image(connection& conn, xcb_shm_seg_t seg, unsigned char* data, uint8_t event_base, uint8_t depth,
+    uint16_t w, uint16_t h)
+    : m_connection(conn)
+    , m_seg(seg)
+    , m_data(data)
+    , m_event_base(event_base)
+    , m_depth(depth)
+    , m_width(w)
+    , m_height(h) {}
+
+shm_image::~shm_image() {
+  wait();
+  xcb_shm_detach(m_connection, m_seg);
+  xcb_flush(m_connection);
+  shmdt(m_data);
+}
+
+unsigned char* shm_image::data() const {
+  return m_data;
+}
+
+int shm_image::stride() const {
+  return m_width * 4;
+}
+
+void shm_image::put(xcb_drawable_t dst, xcb_gcontext_t gc, const xcb_rectangle_t& area) {
+  // The server sends a completion event once it no longer reads from the segment
+  auto cookie = xcb_shm_put_image(m_connection, dst, gc, m_width, m_height, area.x, area.y, area.width, area.height,
+      area.x, area.y, m_depth, XCB_IMAGE_FORMAT_Z_PIXMAP, true, m_seg, 0);
+  m_sequence = cookie.sequence;
+  m_pending = true;
+  m_submitted = std::chrono::steady_clock::now();
+}
+
+bool shm_image::pending() {
+  if (m_pending && std::chrono::steady_clock::now() - m_submitted > PUT_TIMEOUT) {
+    m_pending = false;
+  }
+
+  return m_pending;
+}
+
+bool shm_image::handle(const xcb_generic_event_t* evt) {
+  if ((evt->response_type & ~0x80) != m_event_base + XCB_SHM_COMPLETION) {
+    return false;
+  }
+
+  auto* completion = reinterpret_cast<const xcb_shm_completion_event_t*>(evt);
+  if (completion->shmseg != m_seg) {
+    return false;
+  }
+
+  // The event carries the (truncated) sequence number of its request, ignore completions of puts that timed out
+  if (completion->sequence == static_cast<uint16_t>(m_sequence)) {
+    m_pending = false;
+  }
+  return true;
+}
+
+void shm_image::wait() {
+  if (!m_pending) {
+    return;
+  }
+
+  // Any reply is sent after the preceding requests were processed
+  free(xcb_get_input_focus_reply(m_connection, xcb_get_input_focus(m_connection), nullptr));
+  m_pending = false;
+}
+
+POLYBAR_NS_END
@@ -22,15 +22,8 @@ namespace tray {
  * True transprency is currently not supported here because it cannot be achieved with external compositors (those only
  * seem to work for top-level windows) and has to be implemented by hand.
  */
-client::client(
-    const logger& log, connection& conn, xcb_window_t parent, xcb_window_t win, size s, rgba desired_background)
-    : m_log(log)
-    , m_connection(conn)
-    , m_name(ewmh_util::get_wm_name(win))
-    , m_client(win)
-    , m_size(s)
-    , m_desired_background(desired_background)
-    , m_background_manager(background_manager::make()) {
+client::client(const logger& log, connection& conn, xcb_window_t parent, xcb_window_t win, size s)
+    : m_log(log), m_connection(conn), m_name(ewmh_util::get_wm_name(win)), m_client(win), m_size(s) {
   auto geom = conn.get_geometry(win);
   auto attrs = conn.get_window_attributes(win);
   int client_depth = geom->depth;
@@ -88,8 +81,6 @@ client::client(
 
   m_surface = make_unique<cairo::xcb_surface>(m_connection, m_pixmap, visual, s.w, s.h);
   m_context = make_unique<cairo::context>(*m_surface, m_log);
-
-  observe_background();
 }
 
 client::~client() {
@@ -124,7 +115,7 @@ void client::clear_window() const {
   }
 
   // Do not produce Expose events for the embedder because that triggers an infinite loop.
-  m_connection.clear_area_checked(0, embedder(), 0, 0, width(), height());
+  m_connection.clear_area(0, embedder(), 0, 0, width(), height());
 
   auto send_visibility = [&](uint8_t state) {
     xcb_visibility_notify_event_t evt{};
@@ -132,14 +123,13 @@ void client::clear_window() const {
     evt.window = client_window();
     evt.state = state;
 
-    m_connection.send_event_checked(
-        true, client_window(), XCB_EVENT_MASK_NO_EVENT, reinterpret_cast<const char*>(&evt));
+    m_connection.send_event(true, client_window(), XCB_EVENT_MASK_NO_EVENT, reinterpret_cast<const char*>(&evt));
   };
 
   send_visibility(XCB_VISIBILITY_FULLY_OBSCURED);
   send_visibility(XCB_VISIBILITY_UNOBSCURED);
 
-  m_connection.clear_area_checked(1, client_window(), 0, 0, width(), height());
+  m_connection.clear_area(1, client_window(), 0, 0, width(), height());
 }
 
 void client::update_client_attributes() const {
@@ -249,6 +239,8 @@ void client::add_to_save_set() const {
 
 /**
  * Make sure that the window mapping state is correct
+ *
+ * The requests are not checked, errors are delivered through the event queue.
  */
 void client::ensure_state() const {
   bool new_state = should_be_mapped();
@@ -261,27 +253,31 @@ void client::ensure_state() const {
 
   if (new_state) {
     m_log.trace("%s: Map client", name());
-    m_connection.map_window_checked(embedder());
-    m_connection.map_window_checked(client_window());
+    m_connection.map_window(embedder());
+    m_connection.map_window(client_window());
   } else {
     m_log.trace("%s: Unmap client", name());
-    m_connection.unmap_window_checked(client_window());
-    m_connection.unmap_window_checked(embedder());
+    m_connection.unmap_window(client_window());
+    m_connection.unmap_window(embedder());
   }
 }
 
 /**
  * Configure window position
+ *
+ * The requests are not checked, errors are delivered through the event queue.
+ *
+ * @returns true if the position changed
  */
-void client::set_position(int x, int y) {
-  m_log.trace("%s: moving to (%d, %d)", name(), x, y);
-
+bool client::set_position(int x, int y) {
   position new_pos{x, y};
 
   if (new_pos == m_pos) {
-    return;
+    return false;
   }
 
+  m_log.trace("%s: moving to (%d, %d)", name(), x, y);
+
   m_pos = new_pos;
 
   uint32_t configure_mask = 0;
@@ -293,7 +289,7 @@ void client::set_position(int x, int y) {
   XCB_AUX_ADD_PARAM(&configure_mask, &configure_params, x, x);
   XCB_AUX_ADD_PARAM(&configure_mask, &configure_params, y, y);
   connection::pack_values(configure_mask, &configure_params, configure_values);
-  m_connection.configure_window_checked(embedder(), configure_mask, configure_values.data());
+  m_connection.configure_window(embedder(), configure_mask, configure_values.data());
 
   configure_mask = 0;
   XCB_AUX_ADD_PARAM(&configure_mask, &configure_params, width, m_size.w);
@@ -301,14 +297,13 @@ void client::set_position(int x, int y) {
   XCB_AUX_ADD_PARAM(&configure_mask, &configure_params, x, 0);
   XCB_AUX_ADD_PARAM(&configure_mask, &configure_params, y, 0);
   connection::pack_values(configure_mask, &configure_params, configure_values);
-  m_connection.configure_window_checked(client_window(), configure_mask, configure_values.data());
+  m_connection.configure_window(client_window(), configure_mask, configure_values.data());
 
   xcb_size_hints_t size_hints{};
   xcb_icccm_size_hints_set_size(&size_hints, false, m_size.w, m_size.h);
   xcb_icccm_set_wm_size_hints(m_connection, client_window(), XCB_ATOM_WM_NORMAL_HINTS, &size_hints);
 
-  // The position has changed, we need a new background slice.
-  observe_background();
+  return true;
 }
 
 /**
@@ -328,45 +323,27 @@ void client::configure_notify() const {
   notify.border_width = 0;
 
   unsigned int mask{XCB_EVENT_MASK_STRUCTURE_NOTIFY};
-  m_connection.send_event_checked(false, client_window(), mask, reinterpret_cast<const char*>(&notify));
+  m_connection.send_event(false, client_window(), mask, reinterpret_cast<const char*>(&notify));
 }
 
 /**
- * Redraw background using the observed background slice.
+ * Redraw background by copying this client's area from the shared tray background.
+ *
+ * @param background Background of the whole tray area
+ * @param origin Position of the top-left corner of the background relative to the parent window
+ *
+ * Does not flush the connection.
  */
-void client::update_bg() const {
+void client::update_bg(const cairo::surface& background, position origin) const {
   m_log.trace("%s: Update background", name());
 
-  m_context->clear();
-
-  // Composite background slice with background color.
-  if (m_bg_slice) {
-    auto root_bg = m_bg_slice->get_surface();
-    if (root_bg != nullptr) {
-      *m_context << CAIRO_OPERATOR_SOURCE << *root_bg;
-      m_context->paint();
-      *m_context << CAIRO_OPERATOR_OVER;
-    }
-  }
-  *m_context << m_desired_background;
+  *m_context << CAIRO_OPERATOR_SOURCE;
+  cairo_set_source_surface(*m_context, background, origin.x - m_pos.x, origin.y - m_pos.y);
   m_context->paint();
 
   m_surface->flush();
 
   clear_window();
-  m_connection.flush();
-}
-
-void client::observe_background() {
-  // Opaque backgrounds don't require pseudo-transparency
-  if (!m_transparent) {
-    return;
-  }
-
-  xcb_rectangle_t rect{0, 0, static_cast<uint16_t>(m_size.w), static_cast<uint16_t>(m_size.h)};
-  m_bg_slice = m_background_manager.observe(rect, embedder());
-
-  update_bg();
 }
 
 } // namespace tray
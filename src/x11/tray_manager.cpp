@@ -16,6 +16,7 @@
 #include "utils/memory.hpp"
 #include "utils/process.hpp"
 #include "utils/units.hpp"
+#include "x11/background_manager.hpp"
 #include "x11/ewmh.hpp"
 #include "x11/icccm.hpp"
 #include "x11/window.hpp"
@@ -32,6 +33,9 @@
  *
  * The tray manager needs to trigger bar updates only when the size of the entire tray changes (e.g. when tray icons are
  * added/removed). Everything else can be handled without an update.
+ *
+ * Reconfiguring the clients only queues unchecked requests and flushes the connection once at the end. Errors for
+ * those requests are received asynchronously through the x_error signal, at which point the client is removed.
  */
 
 POLYBAR_NS
@@ -165,6 +169,7 @@ void manager::wait_for_selection(xcb_window_t other) {
 
   m_log.trace("tray: Unembed clients");
   m_clients.clear();
+  free_background();
 
   m_connection.flush();
 
@@ -193,6 +198,7 @@ void manager::deactivate() {
 
   m_log.trace("tray: Unembed clients");
   m_clients.clear();
+  free_background();
 
   m_connection.flush();
 
@@ -237,6 +243,8 @@ void manager::recalculate_width() {
 
 /**
  * Reconfigure client positions and mapped state
+ *
+ * Does not flush the connection.
  */
 void manager::reconfigure_clients() {
   m_log.trace("tray: Reconfigure clients");
@@ -247,26 +255,21 @@ void manager::reconfigure_clients() {
   // X-position of the end of the previous tray icon (including padding)
   unsigned x = 0;
 
-  bool has_error = false;
-
   unsigned count = 0;
 
-  auto reconfigure_client = [&] (auto& client) {
-    try {
-      client->ensure_state();
+  // Whether any client was moved and needs a new background
+  bool moved = false;
 
-      if (client->mapped()) {
-        // Calculate start of tray icon
-        unsigned client_x = x + (count > 0 ? m_opts.spacing : 0) + m_opts.padding;
-        client->set_position(base_x + client_x, calculate_client_y());
-        // Add size and padding to get the end position of the icon
-        x = client_x + m_opts.client_size.w + m_opts.padding;
-        count++;
-      }
-    } catch (const xpp::x::error::window& err) {
-      m_log.err("Failed to reconfigure %s, removing ... (%s)", client->name(), err.what());
-      client.reset();
-      has_error = true;
+  auto reconfigure_client = [&](auto& client) {
+    client->ensure_state();
+
+    if (client->mapped()) {
+      // Calculate start of tray icon
+      unsigned client_x = x + (count > 0 ? m_opts.spacing : 0) + m_opts.padding;
+      moved |= client->set_position(base_x + client_x, calculate_client_y());
+      // Add size and padding to get the end position of the icon
+      x = client_x + m_opts.client_size.w + m_opts.padding;
+      count++;
     }
   };
 
@@ -280,37 +283,117 @@ void manager::reconfigure_clients() {
     }
   }
 
-  if (has_error) {
-    clean_clients();
-  }
-
-  // Some clients may have been (un)mapped or even removed
+  // Some clients may have been (un)mapped
   recalculate_width();
   // The final x position should match the width of the entire tray
   assert(x == m_tray_width);
+
+  if (update_background_area() || moved) {
+    redraw_clients();
+  }
 }
 
 /**
  * Redraw client windows.
+ *
+ * Does not flush the connection.
  */
 void manager::redraw_clients() {
-  if (!is_visible()) {
+  if (!is_visible() || !m_bg_surface) {
     return;
   }
 
   m_log.trace("tray: Refreshing clients");
 
+  paint_background();
+
   for (auto& client : m_clients) {
     try {
       if (client->mapped()) {
-        client->update_bg();
+        client->update_bg(*m_bg_surface, {m_bg_rect.x, m_bg_rect.y});
       }
     } catch (const std::exception& e) {
       m_log.err("tray: Failed to clear %s (%s)", client->name(), e.what());
     }
   }
+}
 
-  m_connection.flush();
+/**
+ * Makes sure the background strip covers the current tray area.
+ *
+ * @returns true if the area changed
+ */
+bool manager::update_background_area() {
+  xcb_rectangle_t rect{static_cast<int16_t>(calculate_x()), static_cast<int16_t>(calculate_client_y()),
+      static_cast<uint16_t>(m_tray_width), static_cast<uint16_t>(m_opts.client_size.h)};
+
+  if (rect.x == m_bg_rect.x && rect.y == m_bg_rect.y && rect.width == m_bg_rect.width &&
+      rect.height == m_bg_rect.height) {
+    return false;
+  }
+
+  free_background();
+  m_bg_rect = rect;
+
+  if (rect.width == 0 || rect.height == 0) {
+    return true;
+  }
+
+  m_log.trace("tray: Allocating background strip %dx%d+%d+%d", rect.width, rect.height, rect.x, rect.y);
+
+  m_bg_pixmap = m_connection.generate_id();
+  m_connection.create_pixmap(m_bar_opts.x_data.depth, m_bg_pixmap, m_opts.selection_owner, rect.width, rect.height);
+  m_bg_surface =
+      make_unique<cairo::xcb_surface>(m_connection, m_bg_pixmap, m_bar_opts.x_data.visual, rect.width, rect.height);
+  m_bg_context = make_unique<cairo::context>(*m_bg_surface, m_log);
+
+  // Opaque backgrounds don't require pseudo-transparency
+  if (m_opts.background.is_transparent()) {
+    m_bg_slice = background_manager::make().observe(rect, m_opts.selection_owner);
+  }
+
+  m_bg_dirty = true;
+  return true;
+}
+
+/**
+ * Composite the background strip from the desktop background and the tray background, if necessary.
+ */
+void manager::paint_background() {
+  if (!m_bg_dirty || !m_bg_context) {
+    return;
+  }
+
+  m_bg_context->clear();
+
+  if (m_bg_slice) {
+    auto root_bg = m_bg_slice->get_surface();
+    if (root_bg != nullptr) {
+      *m_bg_context << CAIRO_OPERATOR_SOURCE << *root_bg;
+      m_bg_context->paint();
+    }
+  }
+
+  *m_bg_context << CAIRO_OPERATOR_OVER << m_opts.background;
+  m_bg_context->paint();
+
+  m_bg_surface->flush();
+
+  m_bg_dirty = false;
+}
+
+void manager::free_background() {
+  m_bg_slice.reset();
+  m_bg_context.reset();
+  m_bg_surface.reset();
+
+  if (m_bg_pixmap != XCB_NONE) {
+    m_connection.free_pixmap(m_bg_pixmap);
+    m_bg_pixmap = XCB_NONE;
+  }
+
+  m_bg_rect = {0, 0, 0U, 0U};
+  m_bg_dirty = true;
 }
 
 /**
@@ -418,8 +501,7 @@ void manager::process_docking_request(xcb_window_t win) {
   m_log.info("tray: Processing docking request from '%s' (%s)", ewmh_util::get_wm_name(win), m_connection.id(win));
 
   try {
-    auto cl =
-        make_unique<client>(m_log, m_connection, m_opts.selection_owner, win, m_opts.client_size, m_opts.background);
+    auto cl = make_unique<client>(m_log, m_connection, m_opts.selection_owner, win, m_opts.client_size);
 
     try {
       cl->query_xembed();
@@ -440,6 +522,7 @@ void manager::process_docking_request(xcb_window_t win) {
     cl->notify_xembed();
 
     m_clients.emplace_back(std::move(cl));
+    m_connection.flush();
   } catch (const std::exception& err) {
     m_log.err("tray: Failed to setup tray client '%s' (%s) removing... (%s)", ewmh_util::get_wm_name(win),
         m_connection.id(win), err.what());
@@ -521,19 +604,6 @@ void manager::remove_client(xcb_window_t win) {
   }
 }
 
-/**
- * Remove all null pointers from client list.
- *
- * Removing clients is often done in two steps:
- * 1. When removing a client during iteration, the unique_ptr is reset.
- * 2. Afterwards all null pointers are removed from the list.
- */
-void manager::clean_clients() {
-  m_clients.erase(
-      std::remove_if(m_clients.begin(), m_clients.end(), [](const auto& client) { return client.get() == nullptr; }),
-      m_clients.end());
-}
-
 bool manager::change_visibility(bool visible) {
   if (m_hidden == !visible) {
     return false;
@@ -563,6 +633,7 @@ bool manager::change_visibility(bool visible) {
 void manager::handle(const evt::expose& evt) {
   if (is_active() && !m_clients.empty() && evt->count == 0) {
     redraw_clients();
+    m_connection.flush();
   }
 }
 
@@ -603,13 +674,9 @@ void manager::handle(const evt::client_message& evt) {
 void manager::handle(const evt::configure_request& evt) {
   if (is_active() && is_embedded(evt->window)) {
     auto client = find_client(evt->window);
-    try {
-      m_log.trace("%s: Client configure request", client->name());
-      client->configure_notify();
-    } catch (const xpp::x::error::window& err) {
-      m_log.err("Failed to reconfigure %s, removing... (%s)", client->name(), err.what());
-      remove_client(evt->window);
-    }
+    m_log.trace("%s: Client configure request", client->name());
+    client->configure_notify();
+    m_connection.flush();
   }
 }
 
@@ -619,13 +686,9 @@ void manager::handle(const evt::configure_request& evt) {
 void manager::handle(const evt::resize_request& evt) {
   if (is_active() && is_embedded(evt->window)) {
     auto client = find_client(evt->window);
-    try {
-      m_log.trace("%s: Client resize request", client->name());
-      client->configure_notify();
-    } catch (const xpp::x::error::window& err) {
-      m_log.err("Failed to reconfigure %s, removing... (%s)", client->name(), err.what());
-      remove_client(evt->window);
-    }
+    m_log.trace("%s: Client resize request", client->name());
+    client->configure_notify();
+    m_connection.flush();
   }
 }
 
@@ -678,6 +741,7 @@ void manager::handle(const evt::property_notify& evt) {
   }
 
   client->ensure_state();
+  m_connection.flush();
 }
 
 /**
@@ -710,8 +774,8 @@ void manager::handle(const evt::destroy_notify& evt) {
     activate();
   } else if (is_active() && is_embedded(evt->window)) {
     m_log.info("tray: Received destroy_notify for client, remove...");
+    // Moves the remaining clients and redraws them if necessary
     remove_client(evt->window);
-    redraw_clients();
   }
 }
 
@@ -722,6 +786,7 @@ void manager::handle(const evt::map_notify& evt) {
   if (is_active() && evt->window == m_opts.selection_owner) {
     m_log.trace("tray: Received map_notify for selection owner");
     redraw_clients();
+    m_connection.flush();
   } else if (is_embedded(evt->window)) {
     auto client = find_client(evt->window);
 
@@ -761,13 +826,36 @@ void manager::handle(const evt::unmap_notify& evt) {
 }
 
 bool manager::on(const signals::ui::update_background&) {
+  m_bg_dirty = true;
   redraw_clients();
+  m_connection.flush();
 
   return false;
 }
 
+/**
+ * Removes clients for which an unchecked request failed.
+ */
+bool manager::on(const signals::ui::x_error& evt) {
+  auto error = evt.cast();
+  auto client = find_client(error.second);
+
+  if (!client) {
+    return false;
+  }
+
+  m_log.err("%s: Request failed with X error %d, removing...", client->name(), error.first);
+  remove_client(*client);
+  return true;
+}
+
 bool manager::on(const signals::ui_tray::tray_pos_change& evt) {
-  int new_x = std::max(0, std::min(evt.cast(), (int)(m_bar_opts.size.w - m_tray_width)));
+  auto [window, x] = evt.cast();
+  if (window != m_bar_opts.x_data.window) {
+    return false;
+  }
+
+  int new_x = std::max(0, std::min(x, (int)(m_bar_opts.size.w - m_tray_width)));
 
   if (new_x != m_pos.x) {
     m_pos.x = new_x;
@@ -0,0 +1,142 @@
+#include "components/config.hpp"
+
+#include "common/test.hpp"
+#include "components/logger.hpp"
+
+using namespace polybar;
+using namespace std;
+
+/**
+ * \brief Fixture class
+ */
+class Config : public ::testing::Test {
+ protected:
+  const logger l = logger(loglevel::NONE);
+
+  sectionmap_t base_sections() {
+    return {
+        {"bar/example", {{"modules-left", "date"}, {"background", "${colors.bg}"}}},
+        {"colors", {{"bg", "#000"}, {"fg", "#fff"}, {"alt", "${self.fg}"}}},
+        {"module/date", {{"type", "internal/date"}, {"label-foreground", "${colors.alt}"}}},
+        {"module/cpu", {{"type", "internal/cpu"}, {"format", "${root.background}"}}},
+    };
+  }
+
+  config make_config(sectionmap_t sections) {
+    config conf(l, "/dev/zero", "example");
+    conf.set_sections(move(sections));
+    return conf;
+  }
+};
+
+TEST_F(Config, sectionChangedIdentical) {
+  auto old_conf = make_config(base_sections());
+  auto new_conf = make_config(base_sections());
+
+  EXPECT_FALSE(new_conf.section_changed(old_conf, "module/date"));
+  EXPECT_FALSE(new_conf.section_changed(old_conf, "module/cpu"));
+  EXPECT_FALSE(new_conf.section_changed(old_conf, "bar/example"));
+  EXPECT_FALSE(new_conf.section_changed(old_conf, "nonexistent"));
+}
+
+TEST_F(Config, sectionChangedDirect) {
+  auto old_conf = make_config(base_sections());
+
+  auto sections = base_sections();
+  sections["module/date"]["label"] = "%date%";
+  auto added = make_config(sections);
+  EXPECT_TRUE(added.section_changed(old_conf, "module/date"));
+  EXPECT_FALSE(added.section_changed(old_conf, "module/cpu"));
+
+  sections = base_sections();
+  sections["module/date"].erase("label-foreground");
+  auto removed = make_config(sections);
+  EXPECT_TRUE(removed.section_changed(old_conf, "module/date"));
+
+  sections = base_sections();
+  sections.erase("module/cpu");
+  auto removed_section = make_config(sections);
+  EXPECT_TRUE(removed_section.section_changed(old_conf, "module/cpu"));
+}
+
+TEST_F(Config, sectionChangedReferences) {
+  auto old_conf = make_config(base_sections());
+
+  // module/date -> colors.alt -> colors.fg
+  auto sections = base_sections();
+  sections["colors"]["fg"] = "#eee";
+  auto changed_fg = make_config(sections);
+  EXPECT_TRUE(changed_fg.section_changed(old_conf, "module/date"));
+  EXPECT_FALSE(changed_fg.section_changed(old_conf, "module/cpu"));
+
+  // module/cpu -> bar/example.background -> colors.bg
+  sections = base_sections();
+  sections["colors"]["bg"] = "#111";
+  auto changed_bg = make_config(sections);
+  EXPECT_TRUE(changed_bg.section_changed(old_conf, "module/cpu"));
+  EXPECT_FALSE(changed_bg.section_changed(old_conf, "module/date"));
+}
+
+TEST_F(Config, sectionChangedIgnoredKeys) {
+  auto old_conf = make_config(base_sections());
+
+  auto sections = base_sections();
+  sections["bar/example"]["modules-left"] = "date cpu";
+  sections["bar/example"]["modules-right"] = "cpu";
+  auto changed = make_config(sections);
+
+  EXPECT_TRUE(changed.section_changed(old_conf, "bar/example"));
+  EXPECT_FALSE(changed.section_changed(old_conf, "bar/example", {"modules-left", "modules-right"}));
+}
+
+TEST_F(Config, sectionChangedCyclicReference) {
+  auto sections = base_sections();
+  sections["colors"]["a"] = "${colors.b}";
+  sections["colors"]["b"] = "${colors.a}";
+  sections["module/date"]["format"] = "${colors.a}";
+
+  auto old_conf = make_config(sections);
+  auto new_conf = make_config(sections);
+
+  EXPECT_FALSE(new_conf.section_changed(old_conf, "module/date"));
+}
+
+TEST_F(Config, dependsOnBar) {
+  auto sections = base_sections();
+  sections["bar/other"] = {{"modules-left", "cpu"}};
+  sections["module/indirect"] = {{"type", "internal/date"}, {"format", "${module/cpu.format}"}};
+  sections["module/explicit"] = {{"type", "internal/date"}, {"format", "${bar/example.background}"}};
+  auto conf = make_config(sections);
+
+  EXPECT_FALSE(conf.depends_on_bar("module/date"));
+  EXPECT_TRUE(conf.depends_on_bar("module/cpu"));
+  EXPECT_TRUE(conf.depends_on_bar("module/indirect"));
+  EXPECT_TRUE(conf.depends_on_bar("module/explicit"));
+  EXPECT_FALSE(conf.depends_on_bar("nonexistent"));
+}
+
+TEST_F(Config, withBar) {
+  auto sections = base_sections();
+  sections["bar/other"] = {{"modules-left", "cpu"}, {"background", "#222"}};
+  auto conf = make_config(sections);
+
+  auto other = conf.with_bar("other");
+  EXPECT_EQ("bar/other", other.section());
+  EXPECT_EQ("cpu", other.get(other.section(), "modules-left"));
+  EXPECT_EQ("#222", other.get("module/cpu", "format"));
+  EXPECT_EQ("#000", conf.get("module/cpu", "format"));
+
+  EXPECT_THROW(conf.with_bar("nonexistent"), application_error);
+}
+
+TEST_F(Config, durationInSeconds) {
+  auto sections = base_sections();
+  sections["module/battery"] = {{"type", "internal/battery"}, {"poll-interval", "5"}};
+  sections["module/other"] = {{"type", "internal/battery"}, {"poll-interval", "0.5"}};
+  auto conf = make_config(sections);
+
+  auto interval = conf.get<chrono::duration<double>>("module/battery", "poll-interval");
+  EXPECT_EQ(5000ms, chrono::duration_cast<chrono::milliseconds>(interval));
+  auto fraction = conf.get<chrono::duration<double>>("module/other", "poll-interval");
+  EXPECT_EQ(500ms, chrono::duration_cast<chrono::milliseconds>(fraction));
+}
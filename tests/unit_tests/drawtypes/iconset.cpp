@@ -39,3 +39,77 @@ TEST(IconSet, fuzzyMatchFallback) {
 
   EXPECT_EQ("fallback_label", ret->get());
 }
+
+TEST(IconSet, fuzzyMatchOverlapping) {
+  iconset_t icons = make_shared<iconset>();
+
+  icons->add("he", make_shared<label>("he"));
+  icons->add("she", make_shared<label>("she"));
+  icons->add("hers", make_shared<label>("hers"));
+  icons->add("his", make_shared<label>("his"));
+  icons->add("fallback_id", make_shared<label>("fallback_label"));
+
+  EXPECT_EQ("she", icons->get("ushe", "fallback_id", true)->get());
+  EXPECT_EQ("hers", icons->get("ushers", "fallback_id", true)->get());
+  EXPECT_EQ("his", icons->get("ahishe", "fallback_id", true)->get());
+  EXPECT_EQ("fallback_label", icons->get("sh", "fallback_id", true)->get());
+}
+
+TEST(IconSet, fuzzyMatchSameLength) {
+  iconset_t icons = make_shared<iconset>();
+
+  icons->add("web", make_shared<label>("web"));
+  icons->add("dev", make_shared<label>("dev"));
+
+  // The lexicographically smallest id wins if multiple ids with the same length match
+  EXPECT_EQ("dev", icons->get("web-dev", "", true)->get());
+  EXPECT_EQ("dev", icons->get("dev-web", "", true)->get());
+}
+
+TEST(IconSet, fuzzyMatchAfterAdd) {
+  iconset_t icons = make_shared<iconset>();
+
+  icons->add("1", make_shared<label>("1"));
+  icons->add("fallback_id", make_shared<label>("fallback_label"));
+
+  EXPECT_EQ("1", icons->get("10a", "fallback_id", true)->get());
+  EXPECT_EQ("fallback_label", icons->get("b", "fallback_id", true)->get());
+
+  // Memoized results must not survive adding icons
+  icons->add("10", make_shared<label>("10"));
+  icons->add("b", make_shared<label>("b"));
+  EXPECT_EQ("10", icons->get("10a", "fallback_id", true)->get());
+  EXPECT_EQ("b", icons->get("ab", "fallback_id", true)->get());
+}
+
+TEST(IconSet, fuzzyMatchBruteForce) {
+  vector<string> ids{"a", "ab", "abc", "b", "bca", "c", "cab", "aaa", "bb", "cc", ""};
+  iconset_t icons = make_shared<iconset>();
+
+  for (const auto& id : ids) {
+    icons->add(id, make_shared<label>("<" + id + ">"));
+  }
+
+  // All strings over {a, b, c} up to length 5
+  vector<string> inputs{""};
+  for (size_t i = 0; i < inputs.size() && inputs[i].size() < 5; i++) {
+    for (char c : {'a', 'b', 'c'}) {
+      inputs.push_back(inputs[i] + c);
+    }
+  }
+
+  for (const auto& input : inputs) {
+    // Longest contained id, smallest on ties
+    string expected;
+    bool found = false;
+    for (const auto& id : ids) {
+      if (input.find(id) != string::npos &&
+          (!found || id.size() > expected.size() || (id.size() == expected.size() && id < expected))) {
+        expected = id;
+        found = true;
+      }
+    }
+
+    EXPECT_EQ("<" + expected + ">", icons->get(input, "", true)->get()) << "Input: " << input;
+  }
+}
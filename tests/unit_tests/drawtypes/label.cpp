@@ -107,3 +107,83 @@ TEST_P(GetTest, soundness) {
   EXPECT_TRUE(m_label->m_maxlen == 0 || actual.length() <= m_label->m_maxlen) << "Returned text is longer than maxlen";
   EXPECT_GE(actual.length(), m_label->m_minlen) << "Returned text is shorter than minlen";
 }
+
+/**
+ * Label with the tokens that load_label would produce for "%name:3:5:~% %index:02% %icon%|%name%"
+ */
+label_t create_token_test_label() {
+  vector<token> tokens;
+  tokens.emplace_back(token{"%name%", 3, 5, "~"});
+  tokens.emplace_back(token{"%index%", 2, 0, "", true});
+  tokens.emplace_back(token{"%icon%"});
+  tokens.emplace_back(token{"%name%"});
+  return make_shared<label>("%name% %index% %icon%|%name%", rgba{}, rgba{}, rgba{}, rgba{}, 0,
+      side_values{ZERO_SPACE, ZERO_SPACE}, side_values{ZERO_SPACE, ZERO_SPACE}, 0, 0_z, alignment::LEFT, true,
+      move(tokens));
+}
+
+TEST(Label, replaceToken) {
+  auto l = create_token_test_label();
+
+  EXPECT_TRUE(l->has_token("%name%"));
+  EXPECT_FALSE(l->has_token("%output%"));
+  EXPECT_EQ("%name% %index% %icon%|%name%", l->get());
+
+  l->replace_token("%name%", "workspace");
+  l->replace_token("%index%", "3");
+  l->replace_token("%icon%", "");
+  l->replace_token("%output%", "ignored");
+
+  EXPECT_FALSE(l->has_token("%name%"));
+  EXPECT_EQ("works~ 03 |workspace", l->get());
+
+  // Tokens that already have a value are not replaced again
+  l->replace_token("%name%", "other");
+  EXPECT_EQ("works~ 03 |workspace", l->get());
+
+  l->reset_tokens();
+  l->replace_token("%name%", "a");
+  EXPECT_EQ("  a %index% %icon%|a", l->get());
+}
+
+TEST(Label, replaceTokenWithToken) {
+  auto l = create_token_test_label();
+
+  // Values are not searched for tokens
+  l->replace_token("%icon%", "%index%");
+  l->replace_token("%index%", "1");
+  EXPECT_EQ("%name% 01 %index%|%name%", l->get());
+}
+
+TEST(Label, clone) {
+  auto l = create_token_test_label();
+  l->m_minlen = 30;
+  l->replace_token("%name%", "first");
+
+  auto copy = l->clone();
+  EXPECT_EQ(30, copy->m_minlen);
+  EXPECT_EQ("%name% %index% %icon%|%name%  ", copy->get());
+
+  copy->replace_token("%name%", "second");
+  EXPECT_EQ("first %index% %icon%|first    ", l->get());
+  EXPECT_EQ("secon~ %index% %icon%|second  ", copy->get());
+}
+
+TEST(Label, clear) {
+  auto l = create_token_test_label();
+  EXPECT_TRUE(*l);
+
+  l->clear();
+  EXPECT_FALSE(*l);
+  EXPECT_FALSE(l->has_token("%name%"));
+  EXPECT_EQ("", l->get());
+
+  l->reset_tokens();
+  EXPECT_TRUE(*l);
+
+  auto empty = make_shared<label>("%output%", rgba{}, rgba{}, rgba{}, rgba{}, 0, side_values{ZERO_SPACE, ZERO_SPACE},
+      side_values{ZERO_SPACE, ZERO_SPACE}, 0, 0_z, alignment::LEFT, true, vector<token>{token{"%output%"}});
+  EXPECT_TRUE(*empty);
+  empty->replace_token("%output%", "");
+  EXPECT_FALSE(*empty);
+}
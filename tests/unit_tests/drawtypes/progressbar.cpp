@@ -0,0 +1,66 @@
+#include "drawtypes/progressbar.hpp"
+
+#include "common/test.hpp"
+#include "drawtypes/label.hpp"
+
+using namespace polybar;
+using namespace polybar::drawtypes;
+
+class ProgressbarTest : public ::testing::Test {
+ protected:
+  /**
+   * Creates a progressbar of width 10 with an indicator
+   */
+  progressbar_t make_bar(vector<rgba> colors, bool gradient) {
+    auto pbar = std::make_shared<progressbar>(opts, 10, "%fill%%indicator%%empty%");
+    pbar->set_gradient(gradient);
+    pbar->set_colors(std::move(colors));
+    pbar->set_fill(std::make_shared<label>("="));
+    pbar->set_empty(std::make_shared<label>("-"));
+    pbar->set_indicator(std::make_shared<label>("|"));
+    return pbar;
+  }
+
+  void expect_same_as_uncached(vector<rgba> colors, bool gradient) {
+    auto cached = make_bar(colors, gradient);
+
+    // Visit every value twice and in an order where neighbouring values are not queried one after another
+    for (int round = 0; round < 2; round++) {
+      for (int i = 0; i <= 100; i++) {
+        int perc = (i * 37) % 101;
+        EXPECT_EQ(make_bar(colors, gradient)->output(perc), cached->output(perc)) << "Percentage: " << perc;
+      }
+    }
+  }
+
+  bar_settings opts{};
+};
+
+TEST_F(ProgressbarTest, output) {
+  auto pbar = make_bar({}, false);
+
+  EXPECT_EQ("|---------", pbar->output(0));
+  EXPECT_EQ("=====|----", pbar->output(55));
+  EXPECT_EQ("=========|", pbar->output(100));
+  EXPECT_EQ("=====|----", pbar->output(55));
+}
+
+TEST_F(ProgressbarTest, cachedNoColors) {
+  expect_same_as_uncached({}, false);
+}
+
+TEST_F(ProgressbarTest, cachedColors) {
+  expect_same_as_uncached({rgba{"#ff0000"}, rgba{"#00ff00"}, rgba{"#0000ff"}}, false);
+}
+
+TEST_F(ProgressbarTest, cachedGradient) {
+  expect_same_as_uncached({rgba{"#ff0000"}, rgba{"#00ff00"}, rgba{"#0000ff"}}, true);
+}
+
+TEST_F(ProgressbarTest, invalidate) {
+  auto pbar = make_bar({}, false);
+  EXPECT_EQ("=====|----", pbar->output(55));
+
+  pbar->set_fill(std::make_shared<label>("#"));
+  EXPECT_EQ("#####|----", pbar->output(55));
+}
@@ -0,0 +1,117 @@
+#include "events/signal_emitter.hpp"
+
+#include <thread>
+
+#include "common/test.hpp"
+#include "events/signal.hpp"
+
+using namespace polybar;
+using namespace signals::eventqueue;
+
+template <int Priority>
+class counting_receiver : public signal_receiver<Priority, notify_change, check_state> {
+ public:
+  explicit counting_receiver(vector<int>& calls, bool handle = false) : m_calls(calls), m_handle(handle) {}
+
+  bool on(const notify_change&) override {
+    m_calls.push_back(Priority);
+    return m_handle;
+  }
+
+  bool on(const check_state&) override {
+    checks++;
+    return true;
+  }
+
+  int checks{0};
+
+ private:
+  vector<int>& m_calls;
+  bool m_handle;
+};
+
+TEST(SignalEmitter, priority) {
+  signal_emitter sig;
+  vector<int> calls;
+  counting_receiver<2> second(calls);
+  counting_receiver<1> first(calls);
+  counting_receiver<3> third(calls);
+
+  sig.attach(&second);
+  sig.attach(&third);
+  sig.attach(&first);
+
+  EXPECT_FALSE(sig.emit(notify_change{}));
+  EXPECT_EQ((vector<int>{1, 2, 3}), calls);
+}
+
+TEST(SignalEmitter, handled) {
+  signal_emitter sig;
+  vector<int> calls;
+  counting_receiver<1> first(calls, true);
+  counting_receiver<2> second(calls);
+
+  sig.attach(&first);
+  sig.attach(&second);
+
+  EXPECT_TRUE(sig.emit(notify_change{}));
+  EXPECT_EQ((vector<int>{1}), calls);
+}
+
+TEST(SignalEmitter, detach) {
+  signal_emitter sig;
+  vector<int> calls;
+  counting_receiver<1> first(calls);
+  counting_receiver<2> second(calls);
+
+  sig.attach(&first);
+  sig.attach(&second);
+  sig.detach(&first);
+
+  EXPECT_FALSE(sig.emit(notify_change{}));
+  EXPECT_EQ((vector<int>{2}), calls);
+
+  // Signals without receivers are not handled
+  EXPECT_FALSE(sig.emit(exit_reload{}));
+}
+
+TEST(SignalEmitter, post) {
+  signal_emitter sig;
+  vector<int> calls;
+  counting_receiver<1> receiver(calls);
+  sig.attach(&receiver);
+
+  std::atomic<int> wakeups{0};
+  sig.set_wakeup([&] { wakeups++; });
+
+  vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 100; j++) {
+        sig.post<notify_change>();
+      }
+    });
+  }
+  sig.post<check_state>();
+
+  for (auto&& t : threads) {
+    t.join();
+  }
+
+  // Nothing is emitted until the posted signals are dispatched, signals that are already queued are coalesced
+  EXPECT_TRUE(calls.empty());
+  EXPECT_EQ(2, wakeups);
+
+  sig.dispatch_posted();
+  EXPECT_EQ(1, calls.size());
+  EXPECT_EQ(1, receiver.checks);
+
+  sig.dispatch_posted();
+  EXPECT_EQ(1, calls.size());
+
+  // Once emitted, the signal is queued again
+  sig.post<notify_change>();
+  EXPECT_EQ(3, wakeups);
+  sig.dispatch_posted();
+  EXPECT_EQ(2, calls.size());
+}
@@ -0,0 +1,83 @@
+#include "ipc/cmdline.hpp"
+
+#include "common/test.hpp"
+#include "ipc/decoder.hpp"
+#include "ipc/encoder.hpp"
+
+using namespace polybar;
+using namespace ipc;
+
+class SplitLineTest : public ::testing::TestWithParam<pair<string, std::deque<string>>> {};
+
+vector<pair<string, std::deque<string>>> split_line_list = {
+    {"", {}},
+    {"   ", {}},
+    {"cmd hide", {"cmd", "hide"}},
+    {"  cmd \t hide  ", {"cmd", "hide"}},
+    {"action date toggle", {"action", "date", "toggle"}},
+    {"action \"#date.toggle\"", {"action", "#date.toggle"}},
+    {"action '#date.toggle'", {"action", "#date.toggle"}},
+    {"action \"#mod.send.some text\"", {"action", "#mod.send.some text"}},
+    {"action mod send 'some text'", {"action", "mod", "send", "some text"}},
+    {"action #mod.send.some\\ text", {"action", "#mod.send.some text"}},
+    {"action \"#mod.send.a \\\"quoted\\\" \\\\ \\n\"", {"action", "#mod.send.a \"quoted\" \\ \\n"}},
+    {"action '#mod.send.\"double\" \\'", {"action", "#mod.send.\"double\" \\"}},
+    {"action \"#mod.send.\"'it'\"s\"", {"action", "#mod.send.its"}},
+    {"action mod send ''", {"action", "mod", "send", ""}},
+};
+
+INSTANTIATE_TEST_SUITE_P(Inst, SplitLineTest, ::testing::ValuesIn(split_line_list));
+
+TEST_P(SplitLineTest, correctness) {
+  EXPECT_EQ(GetParam().second, split_line(GetParam().first));
+}
+
+class SplitLineThrowTest : public ::testing::TestWithParam<string> {};
+
+vector<string> split_line_throw_list = {
+    "action \"#date.toggle",
+    "action '#date.toggle",
+    "action #date.toggle\\",
+};
+
+INSTANTIATE_TEST_SUITE_P(Inst, SplitLineThrowTest, ::testing::ValuesIn(split_line_throw_list));
+
+TEST_P(SplitLineThrowTest, correctness) {
+  EXPECT_THROW(split_line(GetParam()), cmdline_error);
+}
+
+TEST(ParseMessage, action) {
+  auto action = to_integral(v0::ipc_type::ACTION);
+
+  EXPECT_EQ(make_pair(action, "#date.toggle"s), parse_message(split_line("action \"#date.toggle\"")));
+  EXPECT_EQ(make_pair(action, "#date.toggle"s), parse_message(split_line("action date toggle")));
+  EXPECT_EQ(make_pair(action, "#mod.send.some text"s), parse_message(split_line("action \"#mod.send.some text\"")));
+  EXPECT_EQ(make_pair(action, "#mod.send.some text"s), parse_message(split_line("action mod send \"some text\"")));
+  EXPECT_EQ(make_pair(action, "#powermenu.open.0"s), parse_message(split_line("action powermenu open 0")));
+  EXPECT_EQ(make_pair(action, "#mod.hook.1"s), parse_message(split_line("hook module/mod 2")));
+}
+
+TEST(ParseMessage, cmd) {
+  EXPECT_EQ(make_pair(to_integral(v0::ipc_type::CMD), "hide"s), parse_message(split_line("cmd hide")));
+}
+
+TEST(ParseMessage, invalid) {
+  EXPECT_THROW(parse_message(split_line("")), cmdline_error);
+  EXPECT_THROW(parse_message(split_line("action")), cmdline_error);
+  EXPECT_THROW(parse_message(split_line("foo bar")), cmdline_error);
+  EXPECT_THROW(parse_message(split_line("cmd hide now")), cmdline_error);
+  EXPECT_THROW(parse_message(split_line("action mod send some text")), cmdline_error);
+  EXPECT_THROW(parse_message(split_line("hook mod")), cmdline_error);
+}
+
+/**
+ * The batch example from the documentation
+ */
+TEST(ParseMessage, batch) {
+  vector<string> actions;
+  for (auto&& line : {"action \"#title.send.Song\"", "action \"#progress.set.percent=40\""}) {
+    actions.emplace_back(parse_message(split_line(line)).second);
+  }
+
+  EXPECT_EQ(vector<string>({"#title.send.Song", "#progress.set.percent=40"}), decode_batch(encode_batch(actions)));
+}
@@ -94,3 +94,19 @@ TEST_F(DecoderTest, multiple) {
     EXPECT_NO_THROW(dec.on_read(MSG1.data(), MSG1.size()));
   }
 }
+
+TEST_F(DecoderTest, multiple_in_one_read) {
+  vector<uint8_t> data;
+  data.insert(data.end(), MSG2.begin(), MSG2.end());
+  data.insert(data.end(), MSG1.begin(), MSG1.end());
+  data.insert(data.end(), MSG2.begin(), MSG2.end());
+
+  {
+    InSequence seq;
+    EXPECT_CALL(cb, cb(0, TYPE_ACTION, vector<uint8_t>{})).Times(1);
+    EXPECT_CALL(cb, cb(0, TYPE_ACTION, vector<uint8_t>(MSG1.begin() + HEADER_SIZE, MSG1.end()))).Times(1);
+    EXPECT_CALL(cb, cb(0, TYPE_ACTION, vector<uint8_t>{})).Times(1);
+  }
+
+  EXPECT_NO_THROW(dec.on_read(data.data(), data.size()));
+}
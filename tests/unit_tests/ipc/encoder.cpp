@@ -56,3 +56,28 @@ TEST_P(EncoderTest, roundtrip) {
   EXPECT_CALL(cb, cb(0, TYPE_ERR, payload)).Times(1);
   EXPECT_NO_THROW(dec.on_read(encoded.data(), encoded.size()));
 }
+
+TEST(EncodeBatch, roundtrip) {
+  vector<string> actions{"#title.send.Song", "#progress.set.percent=40", "#mod.send.some text"};
+  auto payload = encode_batch(actions);
+  EXPECT_EQ("#title.send.Song\n#progress.set.percent=40\n#mod.send.some text", payload);
+
+  const auto encoded = encode(to_integral(v0::ipc_type::BATCH), payload);
+
+  MockCallback cb;
+  decoder dec{null_logger, [&](uint8_t version, auto type, const auto& data) { cb.cb(version, type, data); }};
+  EXPECT_CALL(cb, cb(0, to_integral(v0::ipc_type::BATCH), vector<uint8_t>(payload.begin(), payload.end()))).Times(1);
+  EXPECT_NO_THROW(dec.on_read(encoded.data(), encoded.size()));
+
+  EXPECT_EQ(actions, decode_batch(payload));
+}
+
+TEST(DecodeBatch, skipsEmptyLines) {
+  EXPECT_EQ(vector<string>({"#a.b", "#c.d"}), decode_batch("\n#a.b\n\n#c.d\n"));
+  EXPECT_EQ(vector<string>{}, decode_batch(""));
+}
+
+TEST(DecodeBatch, rejectsNonActions) {
+  EXPECT_THROW(decode_batch("#a.b\nhide"), decoder::error);
+  EXPECT_THROW(decode_batch("\"#a.b\""), decoder::error);
+}
@@ -166,3 +166,62 @@ TEST(ActionCtxtTest, getActionBlocks) {
   EXPECT_EQ(mousebtn::DOUBLE_MIDDLE, block.button);
   EXPECT_EQ(alignment::RIGHT, block.align);
 }
+
+TEST(ActionCtxtTest, index) {
+  action_context ctxt;
+
+  /*
+   * clang-format off
+   *
+   * Sets up the following actions (LEFT starts at 0, RIGHT at 10):
+   *    0123456789012345
+   * 1: [-------)          (LEFT, LEFT)
+   * 2:  [--)              (LEFT, SCROLL_UP)
+   * 3:    [---)           (LEFT, LEFT)
+   * 4:           [--)     (RIGHT, MIDDLE)
+   * clang-format on
+   */
+
+  auto id1 = ctxt.action_open(mousebtn::LEFT, "", alignment::LEFT, 0);
+  auto id2 = ctxt.action_open(mousebtn::SCROLL_UP, "", alignment::LEFT, 1);
+  ctxt.action_close(mousebtn::SCROLL_UP, alignment::LEFT, 4);
+  auto id3 = ctxt.action_open(mousebtn::LEFT, "", alignment::LEFT, 3);
+  ctxt.action_close(mousebtn::LEFT, alignment::LEFT, 7);
+  ctxt.action_close(mousebtn::LEFT, alignment::LEFT, 8);
+  auto id4 = ctxt.action_open(mousebtn::MIDDLE, "", alignment::RIGHT, 1);
+  ctxt.action_close(mousebtn::MIDDLE, alignment::RIGHT, 4);
+
+  ctxt.set_alignment_start(alignment::LEFT, 0);
+  ctxt.set_alignment_start(alignment::RIGHT, 10);
+
+  vector<map<mousebtn, action_t>> expected;
+  for (int x = -1; x < 16; x++) {
+    expected.push_back(ctxt.get_actions(x));
+  }
+
+  ctxt.build_index();
+
+  for (int x = -1; x < 16; x++) {
+    EXPECT_EQ(expected[x + 1], ctxt.get_actions(x)) << "x = " << x;
+  }
+
+  EXPECT_EQ(NO_ACTION, ctxt.has_action(mousebtn::LEFT, -1));
+  EXPECT_EQ(id1, ctxt.has_action(mousebtn::LEFT, 0));
+  EXPECT_EQ(id2, ctxt.has_action(mousebtn::SCROLL_UP, 3));
+  EXPECT_EQ(id3, ctxt.has_action(mousebtn::LEFT, 3));
+  EXPECT_EQ(id1, ctxt.has_action(mousebtn::LEFT, 7));
+  EXPECT_EQ(NO_ACTION, ctxt.has_action(mousebtn::LEFT, 8));
+  EXPECT_EQ(id4, ctxt.has_action(mousebtn::MIDDLE, 11));
+  EXPECT_EQ(NO_ACTION, ctxt.has_action(mousebtn::MIDDLE, 14));
+
+  auto scroll = make_btn_mask({mousebtn::SCROLL_UP, mousebtn::SCROLL_DOWN});
+  EXPECT_TRUE(ctxt.has_any_action(scroll, 1));
+  EXPECT_FALSE(ctxt.has_any_action(scroll, 4));
+  EXPECT_TRUE(ctxt.has_any_action(make_btn_mask({mousebtn::MIDDLE}), 13));
+  EXPECT_FALSE(ctxt.has_any_action(make_btn_mask({mousebtn::LEFT, mousebtn::MIDDLE}), 9));
+
+  // Modifications invalidate the index
+  ctxt.set_alignment_start(alignment::RIGHT, 20);
+  EXPECT_EQ(NO_ACTION, ctxt.has_action(mousebtn::MIDDLE, 11));
+  EXPECT_EQ(id4, ctxt.has_action(mousebtn::MIDDLE, 21));
+}
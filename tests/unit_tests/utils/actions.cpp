@@ -37,6 +37,8 @@ vector<pair<string, triple<string, string, string>>> parse_action_string_list =
     {"#foo.bar.data", {"foo", "bar", "data"}},
     {"#foo.bar.data.data2", {"foo", "bar", "data.data2"}},
     {"#a.b.c", {"a", "b", "c"}},
+    {"#progress.set.percent=40", {"progress", "set", "percent=40"}},
+    {"#title.set.name=a.b c", {"title", "set", "name=a.b c"}},
     {"#a.b.", {"a", "b", ""}},
     {"#a.b", {"a", "b", ""}},
 };
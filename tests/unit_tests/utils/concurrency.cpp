@@ -0,0 +1,86 @@
+#include "utils/concurrency.hpp"
+
+#include <atomic>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+TEST(Concurrency, parallelForCallsEveryIndexOnce) {
+  vector<std::atomic<int>> calls(100);
+  concurrency_util::parallel_for(calls.size(), [&](size_t i) { calls[i]++; });
+
+  for (const auto& c : calls) {
+    EXPECT_EQ(1, c);
+  }
+}
+
+TEST(Concurrency, parallelForEmpty) {
+  bool called = false;
+  concurrency_util::parallel_for(0, [&](size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(Concurrency, parallelForRethrows) {
+  std::atomic<size_t> calls{0};
+  EXPECT_THROW(concurrency_util::parallel_for(10,
+                   [&](size_t i) {
+                     calls++;
+                     if (i == 3) {
+                       throw std::runtime_error("failed");
+                     }
+                   }),
+      std::runtime_error);
+
+  // The remaining calls still run
+  EXPECT_EQ(10, calls);
+}
+
+TEST(Concurrency, workerPoolRunsRepeatedJobs) {
+  concurrency_util::worker_pool pool(3);
+  EXPECT_EQ(3, pool.size());
+
+  vector<std::atomic<int>> calls(50);
+  for (int job = 0; job < 100; job++) {
+    pool.run(calls.size(), [&](size_t i) { calls[i]++; });
+  }
+
+  for (const auto& c : calls) {
+    EXPECT_EQ(100, c);
+  }
+}
+
+TEST(Concurrency, workerPoolUsesThreads) {
+  concurrency_util::worker_pool pool(2);
+  std::atomic<int> waiting{0};
+
+  // Both calls only return once the other one started, so they must run on different threads
+  pool.run(2, [&](size_t) {
+    waiting++;
+    while (waiting < 2) {
+      this_thread::yield();
+    }
+  });
+
+  EXPECT_EQ(2, waiting);
+}
+
+TEST(Concurrency, workerPoolRethrows) {
+  concurrency_util::worker_pool pool(4);
+  std::atomic<size_t> calls{0};
+
+  EXPECT_THROW(pool.run(10,
+                   [&](size_t i) {
+                     calls++;
+                     if (i == 3) {
+                       throw std::runtime_error("failed");
+                     }
+                   }),
+      std::runtime_error);
+  EXPECT_EQ(10, calls);
+
+  // The pool can still be used after a failed job
+  calls = 0;
+  pool.run(5, [&](size_t) { calls++; });
+  EXPECT_EQ(5, calls);
+}
@@ -0,0 +1,93 @@
+#include "utils/ring_buffer.hpp"
+
+#include <thread>
+
+#include "common/test.hpp"
+
+using namespace polybar;
+
+TEST(RingBuffer, capacityIsPowerOfTwo) {
+  EXPECT_EQ(2, ring_buffer<int>(1).capacity());
+  EXPECT_EQ(8, ring_buffer<int>(8).capacity());
+  EXPECT_EQ(16, ring_buffer<int>(9).capacity());
+}
+
+TEST(RingBuffer, fifo) {
+  ring_buffer<string> buffer(4);
+  int value;
+  string out;
+
+  EXPECT_FALSE(buffer.pop(out));
+
+  EXPECT_TRUE(buffer.push("a"));
+  EXPECT_TRUE(buffer.push("b"));
+  EXPECT_EQ(2, buffer.size());
+
+  EXPECT_TRUE(buffer.pop(out));
+  EXPECT_EQ("a", out);
+  EXPECT_TRUE(buffer.pop(out));
+  EXPECT_EQ("b", out);
+  EXPECT_FALSE(buffer.pop(out));
+  EXPECT_EQ(0, buffer.size());
+
+  // Wraps around
+  ring_buffer<int> numbers(2);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(numbers.push(int{i}));
+    EXPECT_TRUE(numbers.pop(value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+TEST(RingBuffer, fullBufferRejectsPush) {
+  ring_buffer<int> buffer(2);
+  int value;
+
+  EXPECT_TRUE(buffer.push(1));
+  EXPECT_TRUE(buffer.push(2));
+  EXPECT_FALSE(buffer.push(3));
+
+  EXPECT_TRUE(buffer.pop(value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(buffer.push(3));
+}
+
+TEST(RingBuffer, multipleProducers) {
+  const int producers = 4;
+  const int per_producer = 10000;
+  ring_buffer<int> buffer(64);
+  vector<std::thread> threads;
+
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&buffer, p] {
+      for (int i = 0; i < per_producer; i++) {
+        while (!buffer.push(p * per_producer + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  vector<int> last(producers, -1);
+  int received = 0;
+  int value;
+
+  while (received < producers * per_producer) {
+    if (!buffer.pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    // Values of a single producer arrive in order
+    int producer = value / per_producer;
+    EXPECT_LT(last[producer], value % per_producer);
+    last[producer] = value % per_producer;
+    received++;
+  }
+
+  for (auto&& t : threads) {
+    t.join();
+  }
+
+  EXPECT_FALSE(buffer.pop(value));
+}